@@ -0,0 +1,81 @@
+#include "arena.hpp"
+
+#include <mutex>
+
+const unsigned int Arena::maximum_class = 1 << 12; // Larger requests fall through to the scalable allocator
+const unsigned int Arena::chunk_limbs = 1 << 18; // 2MB chunks (with 8-byte limbs)
+
+namespace {
+    typedef std::vector< mp_limb_t * > free_list;
+
+    // Free lists surrendered by exiting threads, waiting for adoption
+    std::mutex orphan_mutex;
+    std::vector< std::vector< free_list > > orphans;
+
+    // Per-thread arena state
+    // On thread exit the free lists are surrendered to the orphan store so that
+    // storage recycled by a worker remains reusable after the worker is joined
+    struct ThreadArena {
+        std::vector< free_list > free_lists; // Recycled arrays indexed by block count
+        mp_limb_t * cursor = NULL; // Next uncarved limb of the current chunk
+        unsigned int remaining = 0; // Number of uncarved limbs left in the current chunk
+        bool active = true; // Cleared on destruction so late deallocations are not recycled
+        tbb::scalable_allocator< mp_limb_t > backing; // Allocator used for backing chunks
+
+        ~ThreadArena(void) {
+            std::lock_guard< std::mutex > guard(orphan_mutex);
+            orphans.emplace_back(std::move(this -> free_lists));
+            this -> active = false;
+        }
+
+        // Attempt to adopt the free lists of an exited thread
+        bool adopt(void) {
+            std::lock_guard< std::mutex > guard(orphan_mutex);
+            if (orphans.empty()) { return false; }
+            std::vector< free_list > adopted = std::move(orphans.back());
+            orphans.pop_back();
+            if (adopted.size() > this -> free_lists.size()) { this -> free_lists.resize(adopted.size()); }
+            for (unsigned int size = 0; size < adopted.size(); ++size) {
+                free_list & local = this -> free_lists[size];
+                local.insert(local.end(), adopted[size].begin(), adopted[size].end());
+            }
+            return true;
+        }
+    };
+
+    thread_local ThreadArena thread_arena;
+}
+
+mp_limb_t * Arena::allocate(unsigned int count) {
+    if (count == 0 || count > Arena::maximum_class || !thread_arena.active) {
+        return (mp_limb_t *) thread_arena.backing.allocate(count);
+    }
+    if (count >= thread_arena.free_lists.size()) { thread_arena.free_lists.resize(count + 1); }
+    if (thread_arena.free_lists[count].empty()) { thread_arena.adopt(); } // Refill from orphaned lists if possible
+    free_list & recycled = thread_arena.free_lists[count];
+    if (!recycled.empty()) {
+        mp_limb_t * blocks = recycled.back();
+        recycled.pop_back();
+        return blocks;
+    }
+    if (thread_arena.remaining < count) { // Carve a fresh chunk
+        // The remainder of the previous chunk is abandoned; chunks are large enough that this waste is negligible
+        thread_arena.cursor = (mp_limb_t *) thread_arena.backing.allocate(Arena::chunk_limbs);
+        thread_arena.remaining = Arena::chunk_limbs;
+    }
+    mp_limb_t * blocks = thread_arena.cursor;
+    thread_arena.cursor += count;
+    thread_arena.remaining -= count;
+    return blocks;
+}
+
+void Arena::deallocate(mp_limb_t * blocks, unsigned int count) {
+    if (count == 0 || count > Arena::maximum_class) {
+        thread_arena.backing.deallocate(blocks, count);
+        return;
+    }
+    // Arrays released after the thread arena is torn down (static destruction order) are abandoned
+    if (!thread_arena.active) { return; }
+    if (count >= thread_arena.free_lists.size()) { thread_arena.free_lists.resize(count + 1); }
+    thread_arena.free_lists[count].emplace_back(blocks);
+}
@@ -0,0 +1,31 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <gmp.h>
+#include <vector>
+#include <tbb/scalable_allocator.h>
+
+// Arena allocator serving the fixed-size block arrays backing Bitmask instances
+// Once the dataset loads, nearly all masks share one of a handful of sizes (samples or features),
+// so recycled arrays are served from per-thread free lists keyed by block count
+// Fresh arrays are carved sequentially out of large chunks, which keeps masks that are
+// allocated together adjacent in memory and removes per-mask allocator contention
+// Free lists orphaned by exiting worker threads are adopted by surviving threads,
+// so recycled storage is retained across fits instead of being returned to the system
+class Arena {
+public:
+    // @param count: the number of blocks to allocate
+    // @returns a pointer to an array of at least count blocks
+    static mp_limb_t * allocate(unsigned int count);
+
+    // @param blocks: a pointer previously returned by allocate
+    // @param count: the number of blocks requested at allocation
+    // @modifies the array is recycled onto the calling thread's free list
+    static void deallocate(mp_limb_t * blocks, unsigned int count);
+
+private:
+    static const unsigned int maximum_class; // Largest block count served from the arena
+    static const unsigned int chunk_limbs; // Number of limbs carved out of each backing chunk
+};
+
+#endif
@@ -1,6 +1,300 @@
 #include "bitmask.hpp"
+#include "arena.hpp"
 #include <cmath>
 #include <cstring>
+#include <mutex>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BITMASK_RUNTIME_SIMD
+#include <immintrin.h>
+#endif
+
+// ********************************
+// ** Vectorized Kernel Backend  **
+// ********************************
+// Runtime-dispatched implementations of the bit-wise kernels
+// The widest instruction set supported by the host is selected once at start-up
+// Each kernel operates in-place on other_blocks, matching the semantics of the GMP mpn_* routines
+// The flip variants fuse the complement of blocks into a single pass instead of materializing it
+
+namespace {
+    typedef void (* bitwise_kernel)(bitblock const * blocks, bitblock * other_blocks, unsigned int count);
+    typedef bool (* equality_kernel)(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask);
+
+    // Portable backend delegating to GMP
+    void mpn_and_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_and_n(other_blocks, other_blocks, blocks, count);
+    }
+    void mpn_and_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_nior_n(other_blocks, other_blocks, other_blocks, count);
+        mpn_nior_n(other_blocks, other_blocks, blocks, count);
+    }
+    void mpn_or_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_ior_n(other_blocks, other_blocks, blocks, count);
+    }
+    void mpn_or_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_nand_n(other_blocks, other_blocks, other_blocks, count);
+        mpn_nand_n(other_blocks, other_blocks, blocks, count);
+    }
+    void mpn_xor_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_xor_n(other_blocks, other_blocks, blocks, count);
+    }
+    void mpn_xor_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        mpn_xnor_n(other_blocks, other_blocks, blocks, count);
+    }
+    bool scalar_equal_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        for (unsigned int i = 0; i + 1 < count; ++i) {
+            if (blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+    bool scalar_equal_flip_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        for (unsigned int i = 0; i + 1 < count; ++i) {
+            if (~blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((~blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+
+#ifdef BITMASK_RUNTIME_SIMD
+    // AVX2 backend processing 256 bits per instruction
+    __attribute__((target("avx2")))
+    void avx2_and_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_and_si256(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] &= blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    void avx2_and_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_andnot_si256(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] &= ~blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    void avx2_or_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_or_si256(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] |= blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    void avx2_or_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        __m256i const ones = _mm256_set1_epi64x(-1);
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_or_si256(_mm256_xor_si256(a, ones), b));
+        }
+        for (; i < count; ++i) { other_blocks[i] |= ~blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    void avx2_xor_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_xor_si256(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] ^= blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    void avx2_xor_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        __m256i const ones = _mm256_set1_epi64x(-1);
+        unsigned int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            _mm256_storeu_si256((__m256i *)(other_blocks + i), _mm256_xor_si256(_mm256_xor_si256(a, ones), b));
+        }
+        for (; i < count; ++i) { other_blocks[i] ^= ~blocks[i]; }
+    }
+    __attribute__((target("avx2")))
+    bool avx2_equal_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        unsigned int i = 0;
+        for (; i + 4 < count; i += 4) { // strictly less-than keeps the final block on the scalar path
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b)) != -1) { return false; }
+        }
+        for (; i + 1 < count; ++i) {
+            if (blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+    __attribute__((target("avx2")))
+    bool avx2_equal_flip_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        __m256i const ones = _mm256_set1_epi64x(-1);
+        unsigned int i = 0;
+        for (; i + 4 < count; i += 4) {
+            __m256i a = _mm256_loadu_si256((__m256i const *)(blocks + i));
+            __m256i b = _mm256_loadu_si256((__m256i const *)(other_blocks + i));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_xor_si256(a, ones), b)) != -1) { return false; }
+        }
+        for (; i + 1 < count; ++i) {
+            if (~blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((~blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+
+    // AVX-512 backend processing 512 bits per instruction
+    __attribute__((target("avx512f")))
+    void avx512_and_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_and_si512(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] &= blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    void avx512_and_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_andnot_si512(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] &= ~blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    void avx512_or_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_or_si512(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] |= blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    void avx512_or_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        __m512i const ones = _mm512_set1_epi64(-1);
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_or_si512(_mm512_xor_si512(a, ones), b));
+        }
+        for (; i < count; ++i) { other_blocks[i] |= ~blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    void avx512_xor_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_xor_si512(a, b));
+        }
+        for (; i < count; ++i) { other_blocks[i] ^= blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    void avx512_xor_flip_kernel(bitblock const * blocks, bitblock * other_blocks, unsigned int count) {
+        __m512i const ones = _mm512_set1_epi64(-1);
+        unsigned int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            _mm512_storeu_si512((void *)(other_blocks + i), _mm512_xor_si512(_mm512_xor_si512(a, ones), b));
+        }
+        for (; i < count; ++i) { other_blocks[i] ^= ~blocks[i]; }
+    }
+    __attribute__((target("avx512f")))
+    bool avx512_equal_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        unsigned int i = 0;
+        for (; i + 8 < count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            if (_mm512_cmpneq_epi64_mask(a, b) != 0) { return false; }
+        }
+        for (; i + 1 < count; ++i) {
+            if (blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+    __attribute__((target("avx512f")))
+    bool avx512_equal_flip_kernel(bitblock const * blocks, bitblock const * other_blocks, unsigned int count, bitblock tail_mask) {
+        __m512i const ones = _mm512_set1_epi64(-1);
+        unsigned int i = 0;
+        for (; i + 8 < count; i += 8) {
+            __m512i a = _mm512_loadu_si512((void const *)(blocks + i));
+            __m512i b = _mm512_loadu_si512((void const *)(other_blocks + i));
+            if (_mm512_cmpneq_epi64_mask(_mm512_xor_si512(a, ones), b) != 0) { return false; }
+        }
+        for (; i + 1 < count; ++i) {
+            if (~blocks[i] != other_blocks[i]) { return false; }
+        }
+        return ((~blocks[count - 1] ^ other_blocks[count - 1]) & tail_mask) == (bitblock)(0);
+    }
+#endif
+
+    // Active backend, overwritten during start-up if a wider instruction set is available
+    bitwise_kernel and_kernel = mpn_and_kernel;
+    bitwise_kernel and_flip_kernel = mpn_and_flip_kernel;
+    bitwise_kernel or_kernel = mpn_or_kernel;
+    bitwise_kernel or_flip_kernel = mpn_or_flip_kernel;
+    bitwise_kernel xor_kernel = mpn_xor_kernel;
+    bitwise_kernel xor_flip_kernel = mpn_xor_flip_kernel;
+    equality_kernel equal_kernel = scalar_equal_kernel;
+    equality_kernel equal_flip_kernel = scalar_equal_flip_kernel;
+
+    // Selects the widest backend supported by the host processor
+    struct KernelDispatch {
+        KernelDispatch(void) {
+#ifdef BITMASK_RUNTIME_SIMD
+            if (__builtin_cpu_supports("avx512f")) {
+                and_kernel = avx512_and_kernel;
+                and_flip_kernel = avx512_and_flip_kernel;
+                or_kernel = avx512_or_kernel;
+                or_flip_kernel = avx512_or_flip_kernel;
+                xor_kernel = avx512_xor_kernel;
+                xor_flip_kernel = avx512_xor_flip_kernel;
+                equal_kernel = avx512_equal_kernel;
+                equal_flip_kernel = avx512_equal_flip_kernel;
+            } else if (__builtin_cpu_supports("avx2")) {
+                and_kernel = avx2_and_kernel;
+                and_flip_kernel = avx2_and_flip_kernel;
+                or_kernel = avx2_or_kernel;
+                or_flip_kernel = avx2_or_flip_kernel;
+                xor_kernel = avx2_xor_kernel;
+                xor_flip_kernel = avx2_xor_flip_kernel;
+                equal_kernel = avx2_equal_kernel;
+                equal_flip_kernel = avx2_equal_flip_kernel;
+            }
+#endif
+        }
+    };
+    KernelDispatch const kernel_dispatch;
+
+    // @param count: the number of blocks participating in a comparison
+    // @param offset: the number of bits used in the final block
+    // @returns a mask selecting the used bits of the final block
+    bitblock tail_mask(unsigned int offset) {
+        if (offset == 0) { return ~((bitblock)(0)); }
+        return ~((bitblock)(0)) >> (Bitmask::bits_per_block - offset);
+    }
+
+    // @param block: a single block of bits
+    // @returns the number of bits set to 1 in the block
+    inline unsigned int block_popcount(bitblock block) {
+#if defined(__GNUC__)
+        return __builtin_popcountll(block);
+#else
+        return mpn_popcount(& block, 1);
+#endif
+    }
+}
 
 // ********************************
 // ** Function Module Definition **
@@ -17,7 +311,6 @@ const bitblock Bitmask::bits_per_block = 8 * sizeof(bitblock);
 const bitblock Bitmask::ranges_per_code = 8 * sizeof(codeblock) / log2((double)(8 * sizeof(rangeblock)));
 const bitblock Bitmask::bits_per_range = log2((double)(8 * sizeof(rangeblock)));
 
-tbb::scalable_allocator< bitblock > Bitmask::allocator = tbb::scalable_allocator< bitblock >();
 bool Bitmask::integrity_check = true;
 bool Bitmask::precomputed = false;
 
@@ -72,22 +365,41 @@ unsigned int Bitmask::count(bitblock * const blocks, unsigned int size) {
     return mpn_popcount(blocks, number_of_blocks);
 }
 
+unsigned int Bitmask::and_count(bitblock * blocks, bitblock * other_blocks, unsigned int size, bool flip) {
+    unsigned int number_of_blocks, block_offset;
+    Bitmask::block_layout(size, & number_of_blocks, & block_offset);
+
+    unsigned int total = 0;
+    bitblock const mask = tail_mask(block_offset);
+    if (!flip) {
+        for (unsigned int i = 0; i + 1 < number_of_blocks; ++i) {
+            total += block_popcount(blocks[i] & other_blocks[i]);
+        }
+        total += block_popcount(blocks[number_of_blocks - 1] & other_blocks[number_of_blocks - 1] & mask);
+    } else {
+        for (unsigned int i = 0; i + 1 < number_of_blocks; ++i) {
+            total += block_popcount(~blocks[i] & other_blocks[i]);
+        }
+        total += block_popcount(~blocks[number_of_blocks - 1] & other_blocks[number_of_blocks - 1] & mask);
+    }
+    return total;
+}
+
 // @note this returns the number of contiguous sequences of 1's
 unsigned int Bitmask::words(bitblock * const blocks, unsigned int size) {
     unsigned int number_of_blocks, block_offset;
     Bitmask::block_layout(size, & number_of_blocks, & block_offset);
     Bitmask::clean(blocks, number_of_blocks, block_offset);
 
-    bool sign = Bitmask::get(blocks, size, 0);
-    unsigned int i = 0;
-    unsigned int j = Bitmask::scan(blocks, size, i, !sign);
+    // A run of ones starts at every set bit with no set bit immediately below it, so the
+    // run count is the popcount of block & ~(block << 1) with the boundary bit threaded
+    // across blocks; this processes a full 64-bit block per step instead of one bit
     unsigned int words = 0;
-    while (j <= size) {
-        if (sign) { ++words; }
-        if (j == size) { break; }
-        i = j;
-        sign = !sign;
-        j = Bitmask::scan(blocks, size, i, !sign);
+    bitblock carry = 0;
+    for (unsigned int index = 0; index < number_of_blocks; ++index) {
+        bitblock block = blocks[index];
+        words += block_popcount(block & ~((block << 1) | carry));
+        carry = block >> (Bitmask::bits_per_block - 1);
     }
     return words;
 }
@@ -98,12 +410,11 @@ void Bitmask::bit_and(bitblock * const blocks, bitblock * other_blocks, unsigned
     Bitmask::clean(blocks, number_of_blocks, block_offset);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_and_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend
+        and_kernel(blocks, other_blocks, number_of_blocks);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_nior_n(other_blocks, other_blocks, other_blocks, number_of_blocks);
-        mpn_nior_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        and_flip_kernel(blocks, other_blocks, number_of_blocks);
     }
 }
 
@@ -113,12 +424,11 @@ void Bitmask::bit_or(bitblock * blocks, bitblock * other_blocks, unsigned int si
     Bitmask::clean(blocks, number_of_blocks, block_offset);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_ior_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend
+        or_kernel(blocks, other_blocks, number_of_blocks);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_nand_n(other_blocks, other_blocks, other_blocks, number_of_blocks);
-        mpn_nand_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        or_flip_kernel(blocks, other_blocks, number_of_blocks);
     }
 }
 
@@ -128,11 +438,11 @@ void Bitmask::bit_xor(bitblock * const blocks, bitblock * other_blocks, unsigned
     Bitmask::clean(blocks, number_of_blocks, block_offset);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_xor_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend
+        xor_kernel(blocks, other_blocks, number_of_blocks);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_xnor_n(other_blocks, other_blocks, blocks, number_of_blocks);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        xor_flip_kernel(blocks, other_blocks, number_of_blocks);
     }
 }
 
@@ -144,14 +454,10 @@ bool Bitmask::equals(bitblock * const blocks, bitblock * const other_blocks, uns
     Bitmask::clean(other_blocks, number_of_blocks, block_offset);
 
     if (!flip) {
-        return mpn_cmp(blocks, other_blocks, number_of_blocks) == 0;
+        return equal_kernel(blocks, other_blocks, number_of_blocks, tail_mask(block_offset));
     } else {
-        mpn_nand_n(blocks, blocks, blocks, number_of_blocks);
-        Bitmask::clean(blocks, number_of_blocks, block_offset);
-        bool equals = mpn_cmp(blocks, other_blocks, number_of_blocks) == 0;
-        mpn_nand_n(blocks, blocks, blocks, number_of_blocks);
-        Bitmask::clean(blocks, number_of_blocks, block_offset);
-        return equals;
+        // The complement of blocks is fused into the comparison instead of being materialized in-place
+        return equal_flip_kernel(blocks, other_blocks, number_of_blocks, tail_mask(block_offset));
     }
 }
 
@@ -345,7 +651,13 @@ std::string Bitmask::to_string(bitblock * const blocks, unsigned int size, bool
 };
 
 void Bitmask::precompute(void) {
-    if (Bitmask::precomputed) { return; }
+    // Lazy and thread-safe: the tables are only built by the first caller that actually
+    // needs the run-length codes, and concurrent first callers block until they exist
+    static std::once_flag precompute_once;
+    std::call_once(precompute_once, Bitmask::precompute_tables);
+}
+
+void Bitmask::precompute_tables(void) {
     Bitmask::precomputed = true;
     std::map< rangeblock, std::vector<char> > collection;
     char block_size = 8 * sizeof(rangeblock);
@@ -485,7 +797,7 @@ Bitmask::Bitmask(Bitmask const & source, bitblock * local_buffer) {
 
 Bitmask::~Bitmask(void) {
     if (this -> shallow == false && valid()) {
-        Bitmask::allocator.deallocate(this -> content, this -> _max_blocks);
+        Arena::deallocate(this -> content, this -> _max_blocks);
     }
 }
 
@@ -495,7 +807,7 @@ void Bitmask::initialize(unsigned int size, bitblock * local_buffer) {
     Bitmask::block_layout(this -> _size, & num_blocks, & (this -> _offset));
     this -> _used_blocks = this -> _max_blocks = num_blocks;
     if (local_buffer == NULL) {
-        this -> content = (bitblock *) Bitmask::allocator.allocate(this -> _max_blocks);
+        this -> content = (bitblock *) Arena::allocate(this -> _max_blocks);
     } else {
         this -> content = local_buffer;
         this -> shallow = true;
@@ -559,6 +871,27 @@ Bitmask & Bitmask::operator=(Bitmask const & other) {
     return * this;
 }
 
+void Bitmask::attach(bitblock * source_blocks, unsigned int size) {
+    if (this -> shallow == false && valid()) { Arena::deallocate(this -> content, this -> _max_blocks); }
+    this -> _size = size;
+    unsigned int num_blocks;
+    Bitmask::block_layout(size, & num_blocks, & (this -> _offset));
+    this -> _used_blocks = this -> _max_blocks = num_blocks;
+    this -> content = source_blocks;
+    this -> shallow = true;
+    this -> set_depth_budget(0);
+}
+
+void Bitmask::swap(Bitmask & other) {
+    std::swap(this -> content, other.content);
+    std::swap(this -> _size, other._size);
+    std::swap(this -> _offset, other._offset);
+    std::swap(this -> _used_blocks, other._used_blocks);
+    std::swap(this -> _max_blocks, other._max_blocks);
+    std::swap(this -> shallow, other.shallow);
+    std::swap(this -> depth_budget, other.depth_budget);
+}
+
 bitblock * Bitmask::data(void) const {
     if (Bitmask::integrity_check && !valid()) {
         std::stringstream reason;
@@ -744,19 +1077,7 @@ unsigned int Bitmask::words(void) const {
         throw IntegrityViolation("Bitmask::words", reason.str());
     }
 
-    unsigned int max = size();
-    bool sign = get(0);
-    unsigned int i = 0;
-    unsigned int j = scan(i, !sign);
-    unsigned int words = 0;
-    while (j <= max) {
-        if (sign) { ++words; }
-        if (j == max) { break; }
-        i = j;
-        sign = !sign;
-        j = scan(i, !sign);
-    }
-    return words;
+    return Bitmask::words(this -> content, this -> _size);
 }
 
 void Bitmask::bit_and(bitblock * other_blocks, bool flip) const {
@@ -781,15 +1102,25 @@ void Bitmask::bit_and(Bitmask const & other, bool flip) const {
     unsigned int block_count = std::min(this -> _used_blocks, other._used_blocks);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_and_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend
+        and_kernel(blocks, other_blocks, block_count);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_nior_n(other_blocks, other_blocks, other_blocks, block_count);
-        mpn_nior_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        and_flip_kernel(blocks, other_blocks, block_count);
     }
 };
 
+unsigned int Bitmask::and_count(Bitmask const & other, bool flip) const {
+    if (this -> _size == 0 && other._size == 0) { return 0; }
+    if (Bitmask::integrity_check && (!valid() || !other.valid())) {
+        std::stringstream reason;
+        reason << "Operating with invalid data";
+        throw IntegrityViolation("Bitmask::and_count", reason.str());
+    }
+    unsigned int size = std::min(this -> _size, other._size);
+    return Bitmask::and_count(this -> content, other.content, size, flip);
+}
+
 void Bitmask::bit_or(bitblock * other_blocks, bool flip) const {
     if (Bitmask::integrity_check && (!valid() || other_blocks == NULL)) {
         std::stringstream reason;
@@ -811,12 +1142,11 @@ void Bitmask::bit_or(Bitmask const & other, bool flip) const {
     unsigned int block_count = std::min(this -> _used_blocks, other._used_blocks);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_ior_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend
+        or_kernel(blocks, other_blocks, block_count);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_nand_n(other_blocks, other_blocks, other_blocks, block_count);
-        mpn_nand_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        or_flip_kernel(blocks, other_blocks, block_count);
     }
 };
 
@@ -841,11 +1171,11 @@ void Bitmask::bit_xor(Bitmask const & other, bool flip) const {
     unsigned int block_count = std::min(this -> _used_blocks, other._used_blocks);
 
     if (!flip) {
-        // Special Offload to GMP Implementation
-        mpn_xor_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend
+        xor_kernel(blocks, other_blocks, block_count);
     } else {
-        // Special Offload to GMP Implementation
-        mpn_xnor_n(other_blocks, blocks, other_blocks, block_count);
+        // Offload to the dispatched kernel backend, the complement is fused into a single pass
+        xor_flip_kernel(blocks, other_blocks, block_count);
     }
 };
 
@@ -943,9 +1273,14 @@ size_t Bitmask::hash(bool bitwise) const {
     //     sign = !sign;
     //     j = scan(i, !sign);
     // }
+    // Multiply-rotate mixing (splitmix-style finalizer constants); unlike the previous
+    // shift-xor chain, a single multiply diffuses each block across the full word
     bitblock * blocks = this -> content;
     for (unsigned int i = 0; i < this -> _used_blocks; ++i) {
-        seed ^= blocks[i] + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= blocks[i];
+        seed *= 0x9e3779b97f4a7c15ULL;
+        seed = (seed << 27) | (seed >> 37);
+        seed *= 0xbf58476d1ce4e5b9ULL;
     }
     return seed;
 }
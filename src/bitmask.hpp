@@ -9,7 +9,6 @@
 #include <sstream>
 #include <gmp.h>
 //#include <boost/dynamic_bitset.hpp>
-//#include <simdpp/simd.h>
 #include <tbb/scalable_allocator.h>
 
 #include "integrity_violation.hpp"
@@ -24,6 +23,7 @@ typedef char codeblock; // Type used to store run-length codes for each precompu
 // The static class methods implements a function module providing operations on arrays of type bitblock, which can be allocated on the stack
 // The non-static class methods implementes a heap-allocated equivalent, which supports the same methods
 // @note: Many of the binary operations assume that operands have the same length
+// @note: The bit-wise kernels dispatch to an AVX2 or AVX-512 backend at start-up when the host supports one, falling back to GMP otherwise
 class Bitmask {
 public:
     static const bitblock ranges_per_code; // Number of ranges that can be encoded using a single codeblock
@@ -64,6 +64,13 @@ public:
     // @returns the number of represented bits which are set to 1
     static unsigned int count(bitblock * blocks, unsigned int size);
 
+    // @param blocks: blocks which act as a vector of bits for a bit-wise logical and
+    // @param other_blocks: blocks which act as a vector of bits for a bit-wise logical and
+    // @param size: the number of bits which are represented in blocks and other_blocks
+    // @param flip: whether or not to interpret the bits of blocks as flipped before applying the bit-wise operation
+    // @returns the number of bits set to 1 in the conjunction, computed in a single pass without materializing the result
+    static unsigned int and_count(bitblock * blocks, bitblock * other_blocks, unsigned int size, bool flip = false);
+
     // @param blocks: the blocks from which to compute the number of contiguous ranges of bits which are set to 1
     // @param size: the number of bits which are represented in blocks
     // @returns the estimated number of contiguous ranges of bits which are set to 1
@@ -152,7 +159,8 @@ public:
     static std::vector< size_t > hashes; // Precomputed hashes in rangeblock-sized sequences
     static std::vector< char > counts; // Precomputed population counts in rangeblock-sized sequences
 
-    static void precompute(void); // Perform the one-time precomputation for rangeblock-sized sequences
+    static void precompute(void); // Lazily build the run-length-code tables; safe to call from concurrent threads
+    static void precompute_tables(void); // Perform the one-time precomputation for rangeblock-sized sequences
     static void benchmark(unsigned int size); // Run a benchmark for a bitmask of the given size
 
     Bitmask(void);
@@ -180,6 +188,17 @@ public:
     // Aliases to copy_from
     Bitmask & operator=(Bitmask const & other);
 
+    // @param source_blocks: externally owned storage containing the bits
+    // @param size: the number of bits represented in source_blocks
+    // @modifies content: this instance becomes a shallow view over source_blocks without copying
+    // @note the caller retains ownership of source_blocks and must guarantee the unused bits of the last block are zero
+    void attach(bitblock * source_blocks, unsigned int size);
+
+    // @param other: the bitmask to exchange contents with
+    // @modifies content: ownership of the underlying blocks is exchanged with other, no bits are copied
+    // @note the shallow flag travels with the storage, so a shallow operand makes the other operand shallow
+    void swap(Bitmask & other);
+
     // @returns a pointer to the blocks of this instance
     bitblock * data(void) const;
 
@@ -229,6 +248,11 @@ public:
     void bit_xor(Bitmask const & other, bool flip = false) const;
     void bit_or(Bitmask const & other, bool flip = false) const;
 
+    // @param other: the second operand vector of blocks of bits
+    // @param flip: whether or not to treat the bits of this instance as flipped before applying the operation
+    // @returns the number of bits set to 1 in the conjunction, without modifying either operand
+    unsigned int and_count(Bitmask const & other, bool flip = false) const;
+
     // @modifes: sets every bit to zero
     void clear(void);
 
@@ -299,7 +323,6 @@ private:
                                 // 1 means no further splits allowed - a (sub)tree with only one node is depth 1.
                                 // 0 means there is no constraint on allowable depth
 
-    static tbb::scalable_allocator<bitblock> allocator; // Allocator used to managing memory
     bitblock * content = NULL; // A pointer the blocks containing the bits
     unsigned int _size = 0; // The number of bits actually being used (excludes leading zeros in final block)
     unsigned int _offset = 0; // The number of bits used in the last used block by this object instance
@@ -2,54 +2,152 @@
 #define CONFIGURATION_H
 
 #include <iostream>
+#include <vector>
 #include <json/json.hpp>
 #include "reference.hpp"
 
 using json = nlohmann::json;
 
-// Static configuration object used to modifie the algorithm behaviour
-// By design, all running instances of the algorithm within the same process must share the same configuration
+// Configuration object used to modify the algorithm behaviour
+// Each thread reads configuration through a bound instance of Values, so concurrent fits in
+// one process can each carry their own configuration. A thread that has not been bound (the
+// usual case for a caller configuring before a fit) reads and writes its own thread-local
+// default instance, which GOSDT::fit adopts and binds when the optimization starts
 class Configuration {
 public:
+    // The full set of configuration parameters with their default values
+    struct Values {
+        float uncertainty_tolerance = 0.0; // The maximum allowed global optimality before the optimization can terminate
+        float regularization = 0.05; // The penalty incurred for each leaf in the model
+        std::vector< float > regularization_sweep; // Sequence of regularization values solved in one process, reusing the dependency graph between solves. Empty means a single solve
+        bool allow_small_reg = false; // Flag for allowing regularization < 1/n , where n = num_samples (if false, regularizations below 1/n are automatically set to 1/n)
+        float upperbound = 0.0; // Upperbound on the root problem for pruning problems using a greedy model
+
+        unsigned int time_limit = 0; // The maximum allowed runtime (seconds). 0 means unlimited.
+        unsigned int worker_limit = 1; // The maximum allowed worker threads. 0 means match number of available cores
+        unsigned int stack_limit = 0; // The maximum amount of stack space (bytes) allowed to use as buffers
+        unsigned int precision_limit = 0; // The maximum number of significant figures considered for each ordinal feature
+        unsigned int model_limit = 1; // The maximum number of models extracted
+        unsigned int memory_limit = 0; // Resident memory budget (MB): nearing it triggers garbage collection and depth-prioritized exploration; exceeding it despite collection ends the run with the best model found. 0 means disabled
+        unsigned int checkpoint_interval = 600; // The number of seconds between checkpoint snapshots when a checkpoint path is configured
+
+        bool verbose = false; // Flag for printing status to standard output
+        bool diagnostics = false; // Flag for printing diagnosis to standard output if a bug is detected
+
+        bool autotune = false; // Flag for choosing the bound flags (look_ahead, similar_support, feature_exchange, continuous_feature_exchange, cancellation) by short probe solves before the full solve, overriding the configured combination with the winner
+        unsigned int autotune_budget = 2; // Time budget (seconds) granted to each autotune probe solve
+
+        bool anytime = false; // Flag for writing the current best model and its optimality gap to the model path whenever the global upperbound improves, so an interrupted run still yields a tree
+
+        bool threshold_guessing = false; // Flag for pruning ordinal thresholds down to the ones used by a boosted stump ensemble trained during encoding
+        unsigned int threshold_guessing_rounds = 64; // The number of boosting rounds used to select thresholds when threshold_guessing is enabled
+
+        unsigned char depth_budget = 0; // The maximum tree depth for solutions, counting a tree with just the root node as depth 1. 0 means unlimited.
+        bool reference_LB = false; // Flag for using a vector of misclassifications from another (reference) model to lower bound our own misclassifications
+        std::string path_to_labels; //if reference_LB is true, gives file path to the labels from the reference model. Otherwise, not used
+        //if reference lb is true, configure instantiates the Reference class with the appropriate labels
+
+        std::string priority_policy = "support"; // Exploration queue ordering: 'support' pops the largest promising supports first, 'lowerbound' the best lower bounds, 'gap' the largest optimality gaps, 'depth' the smallest subproblems (minimizing the live frontier), and 'hybrid' follows 'support' with an epsilon chance of a random rank
+        float priority_epsilon = 0.1; // Probability that the 'hybrid' policy assigns a message a uniform random priority instead of the policy's rank
+
+        bool balance = false; // Flag for adjusting the importance of each row to equalize the total importance of each class (overrides weight)
+        bool look_ahead = true; // Flag for enabling the one-step look-ahead bound implemented via scopes
+        bool similar_support = true; // Flag for enabling the similar support bound imeplemented via the distance index
+        bool cancellation = true; // Flag for enabling upward propagation of cancelled subproblems
+        bool continuous_feature_exchange = false; // Flag for enabling the pruning of neighbouring thresholds using subset comparison
+        bool feature_exchange = false; // Flag for enabling the pruning of pairs of features using subset comparison
+        bool feature_transform = true; // Flag for enabling the equivalence discovery through simple feature transformations
+        bool canonical_tiles = false; // Flag for keying vertices on canonical tiles so subproblems identical up to column order share one vertex; the larger keys slow every graph access, so this only pays off on datasets with heavily repeated structure
+        bool rule_list = false; // Flag for enabling rule-list constraints on models
+        bool non_binary = false; // Flag for enabling non-binary encoding
+
+        std::string costs; // Path to file containing cost matrix
+        std::string weights; // Path to file containing one importance weight per sample, one value per line in sample order. Empty string weighs every sample equally
+        std::string dataset_cache; // Path to file used to cache the encoded dataset in binary form. Empty string disables caching
+        std::string model; // Path to file used to store the extracted models
+        std::string binary_model; // Path to file used to store the extracted models in compact binary form (see model.cpp for the layout). Empty string disables binary output
+        std::string timing; // Path to file used to store training time
+        std::string trace; // Path to directory used to store traces
+        std::string tree; // Path to directory used to store tree-traces
+        std::string profile; // Path to file used to log runtime statistics
+        std::string checkpoint; // Path to file used to persist optimization state for later resumption. Empty string disables checkpointing
+        std::string bound_channel; // Path to file used to share the best known objective upperbound between cooperating processes solving the same instance; a process whose own upperbound is worse adopts the shared bound for pruning, like the upperbound option. Empty string disables sharing
+    };
+
+    // @returns the configuration bound to the calling thread, or the thread's own default instance
+    static Values & active(void);
+
+    // @param values: the configuration instance that the calling thread should read from now on
+    // @note passing NULL restores the thread's default instance
+    static void bind(Values * values);
+
+    // @returns the instance pointer currently bound to the calling thread, or NULL if the
+    //          thread reads its default instance; pass the result back to bind to restore
+    //          the thread after temporarily binding it to another instance
+    static Values * binding(void);
+
     static void configure(std::istream & configuration);
     static void configure(json source);
     static std::string to_string(unsigned int spacing = 0);
 
-    static float uncertainty_tolerance; // The maximum allowed global optimality before the optimization can terminate
-    static float regularization; // The penalty incurred for each leaf in the model
-    static bool allow_small_reg; // Flag for allowing regularization < 1/n , where n = num_samples (if false, regularizations below 1/n are automatically set to 1/n)
-    static float upperbound; // Upperbound on the root problem for pruning problems using a greedy model
-
-    static unsigned int time_limit; // The maximum allowed runtime (seconds). 0 means unlimited.
-    static unsigned int worker_limit; // The maximum allowed worker threads. 0 means match number of available cores
-    static unsigned int stack_limit; // The maximum amount of stack space (bytes) allowed to use as buffers
-    static unsigned int precision_limit; // The maximum number of significant figures considered for each ordinal feature
-    static unsigned int model_limit; // The maximum number of models extracted
-
-    static bool verbose; // Flag for printing status to standard output
-    static bool diagnostics; // Flag for printing diagnosis to standard output if a bug is detected
-
-    static unsigned char depth_budget; // The maximum tree depth for solutions, counting a tree with just the root node as depth 1. 0 means unlimited.
-    static bool reference_LB; // Flag for using a vector of misclassifications from another (reference) model to lower bound our own misclassifications
-    static std::string path_to_labels; //if reference_LB is true, gives file path to the labels from the reference model. Otherwise, not used
-    //if reference lb is true, configure instantiates the Reference class with the appropriate labels
-
-    static bool balance; // Flag for adjusting the importance of each row to equalize the total importance of each class (overrides weight)
-    static bool look_ahead; // Flag for enabling the one-step look-ahead bound implemented via scopes
-    static bool similar_support; // Flag for enabling the similar support bound imeplemented via the distance index
-    static bool cancellation; // Flag for enabling upward propagation of cancelled subproblems
-    static bool continuous_feature_exchange; // Flag for enabling the pruning of neighbouring thresholds using subset comparison
-    static bool feature_exchange; // Flag for enabling the pruning of pairs of features using subset comparison
-    static bool feature_transform; // Flag for enabling the equivalence discovery through simple feature transformations
-    static bool rule_list; // Flag for enabling rule-list constraints on models
-    static bool non_binary; // Flag for enabling non-binary encoding
-
-    static std::string costs; // Path to file containing cost matrix
-    static std::string model; // Path to file used to store the extracted models
-    static std::string timing; // Path to file used to store training time
-    static std::string trace; // Path to directory used to store traces
-    static std::string tree; // Path to directory used to store tree-traces
-    static std::string profile; // Path to file used to log runtime statistics
+    static float & uncertainty_tolerance(void) { return active().uncertainty_tolerance; }
+    static float & regularization(void) { return active().regularization; }
+    static std::vector< float > & regularization_sweep(void) { return active().regularization_sweep; }
+    static bool & allow_small_reg(void) { return active().allow_small_reg; }
+    static float & upperbound(void) { return active().upperbound; }
+
+    static unsigned int & time_limit(void) { return active().time_limit; }
+    static unsigned int & worker_limit(void) { return active().worker_limit; }
+    static unsigned int & stack_limit(void) { return active().stack_limit; }
+    static unsigned int & precision_limit(void) { return active().precision_limit; }
+    static unsigned int & model_limit(void) { return active().model_limit; }
+    static unsigned int & memory_limit(void) { return active().memory_limit; }
+    static unsigned int & checkpoint_interval(void) { return active().checkpoint_interval; }
+
+    static bool & verbose(void) { return active().verbose; }
+    static bool & diagnostics(void) { return active().diagnostics; }
+
+    static bool & autotune(void) { return active().autotune; }
+    static unsigned int & autotune_budget(void) { return active().autotune_budget; }
+
+    static bool & anytime(void) { return active().anytime; }
+
+    static bool & threshold_guessing(void) { return active().threshold_guessing; }
+    static unsigned int & threshold_guessing_rounds(void) { return active().threshold_guessing_rounds; }
+
+    static unsigned char & depth_budget(void) { return active().depth_budget; }
+    static bool & reference_LB(void) { return active().reference_LB; }
+    static std::string & path_to_labels(void) { return active().path_to_labels; }
+
+    static std::string & priority_policy(void) { return active().priority_policy; }
+    static float & priority_epsilon(void) { return active().priority_epsilon; }
+
+    static bool & balance(void) { return active().balance; }
+    static bool & look_ahead(void) { return active().look_ahead; }
+    static bool & similar_support(void) { return active().similar_support; }
+    static bool & cancellation(void) { return active().cancellation; }
+    static bool & continuous_feature_exchange(void) { return active().continuous_feature_exchange; }
+    static bool & feature_exchange(void) { return active().feature_exchange; }
+    static bool & feature_transform(void) { return active().feature_transform; }
+    static bool & canonical_tiles(void) { return active().canonical_tiles; }
+    static bool & rule_list(void) { return active().rule_list; }
+    static bool & non_binary(void) { return active().non_binary; }
+
+    static std::string & costs(void) { return active().costs; }
+    static std::string & weights(void) { return active().weights; }
+    static std::string & dataset_cache(void) { return active().dataset_cache; }
+    static std::string & model(void) { return active().model; }
+    static std::string & binary_model(void) { return active().binary_model; }
+    static std::string & timing(void) { return active().timing; }
+    static std::string & trace(void) { return active().trace; }
+    static std::string & tree(void) { return active().tree; }
+    static std::string & profile(void) { return active().profile; }
+    static std::string & checkpoint(void) { return active().checkpoint; }
+    static std::string & bound_channel(void) { return active().bound_channel; }
+
+private:
+    static thread_local Values default_values; // Fallback instance for threads that are not bound
+    static thread_local Values * bound; // The instance bound to the calling thread, if any
 };
 
 #endif
@@ -0,0 +1,157 @@
+#include "daemon.hpp"
+
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // 64-bit FNV-1a digest of the dataset content, so a rewritten file under the same path
+    // is not served from a stale instance
+    unsigned long long content_digest(std::string const & content) {
+        unsigned long long digest = 14695981039346656037ULL;
+        for (size_t i = 0; i < content.size(); ++i) {
+            digest ^= (unsigned char)(content[i]);
+            digest *= 1099511628211ULL;
+        }
+        return digest;
+    }
+
+    // @param connection: open stream socket
+    // @returns the request bytes, read until the client shuts down its write side
+    std::string read_request(int connection) {
+        std::string request;
+        char buffer[4096];
+        ssize_t count;
+        while ((count = read(connection, buffer, sizeof(buffer))) > 0) { request.append(buffer, count); }
+        return request;
+    }
+
+    // @param connection: open stream socket
+    // @param response: the response bytes to send, resuming across partial writes
+    void write_response(int connection, std::string const & response) {
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t count = write(connection, response.data() + sent, response.size() - sent);
+            if (count <= 0) { break; }
+            sent += count;
+        }
+    }
+}
+
+Daemon::Daemon(void) {}
+Daemon::~Daemon(void) {}
+
+int Daemon::serve(std::string const & socket_path) {
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cout << "Failed to create socket: " << socket_path << std::endl;
+        return 1;
+    }
+    struct sockaddr_un address;
+    std::memset(& address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path too long: " << socket_path << std::endl;
+        close(listener);
+        return 1;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(socket_path.c_str()); // Replace a stale socket left behind by a previous run
+    if (bind(listener, (struct sockaddr *)(& address), sizeof(address)) != 0
+        || listen(listener, 4) != 0) {
+        std::cout << "Failed to listen on socket: " << socket_path << std::endl;
+        close(listener);
+        return 1;
+    }
+    std::cout << "Listening on " << socket_path << std::endl;
+
+    bool shutdown_requested = false;
+    while (!shutdown_requested) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) { continue; }
+        json response = json::object();
+        try {
+            json request = json::parse(read_request(connection));
+            if (request.contains("command") && request["command"] == "shutdown") {
+                shutdown_requested = true;
+                response["status"] = "shutdown";
+            } else {
+                response = dispatch(request);
+            }
+        } catch (std::exception const & error) {
+            response["error"] = std::string(error.what());
+        } catch (char const * error) { // Configuration errors are thrown as string literals
+            response["error"] = std::string(error);
+        }
+        write_response(connection, response.dump());
+        close(connection);
+    }
+    close(listener);
+    unlink(socket_path.c_str());
+    return 0;
+}
+
+json Daemon::dispatch(json const & request) {
+    json response = json::object();
+    if (!request.contains("data")) {
+        response["error"] = "Request missing 'data' path";
+        return response;
+    }
+    std::string path = request["data"].get< std::string >();
+    std::ifstream data(path);
+    if (!data.good()) {
+        response["error"] = "File Not Found: " + path;
+        return response;
+    }
+
+    // Each request starts from default settings on an unbound thread; the fit below
+    // snapshots the configuration into the served instance
+    Configuration::bind(NULL);
+    State::bind(NULL);
+    Configuration::active() = Configuration::Values();
+    if (request.contains("config")) { Configuration::configure(request["config"]); }
+
+    std::stringstream content_buffer;
+    content_buffer << data.rdbuf();
+    std::string content = content_buffer.str();
+
+    std::string result;
+    std::string key = instance_key(path, content);
+    auto cached = this -> instances.find(key);
+    if (cached == this -> instances.end()) {
+        std::unique_ptr< GOSDT > instance(new GOSDT());
+        instance -> retain(true); // The dataset must survive the fit for later reuse
+        std::istringstream content_stream(content);
+        instance -> fit(content_stream, result);
+        this -> instances.emplace(key, std::move(instance));
+    } else {
+        cached -> second -> fit(result); // Reuses the dataset loaded by an earlier request
+    }
+
+    response["models"] = json::parse(result);
+    response["time"] = GOSDT::time;
+    response["iterations"] = GOSDT::iterations;
+    response["lower_bound"] = GOSDT::lower_bound;
+    response["upper_bound"] = GOSDT::upper_bound;
+    response["model_loss"] = GOSDT::model_loss;
+    return response;
+}
+
+std::string Daemon::instance_key(std::string const & path, std::string const & content) const {
+    // A cached dataset is only valid for requests whose configuration shapes the loaded
+    // dataset the same way, so those fields join the path and content digest in the key
+    std::stringstream key;
+    key << path << ":" << content_digest(content)
+        << ":" << Configuration::costs()
+        << ":" << Configuration::weights()
+        << ":" << Configuration::balance()
+        << ":" << Configuration::non_binary()
+        << ":" << Configuration::precision_limit()
+        << ":" << Configuration::threshold_guessing()
+        << ":" << Configuration::threshold_guessing_rounds()
+        << ":" << Configuration::reference_LB()
+        << ":" << Configuration::path_to_labels()
+        << ":" << Configuration::similar_support();
+    return key.str();
+}
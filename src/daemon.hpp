@@ -0,0 +1,53 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <json/json.hpp>
+
+#include "configuration.hpp"
+#include "gosdt.hpp"
+
+using json = nlohmann::json;
+
+// Long-running server mode of the command line interface
+// The process stays resident and keeps fitted instances (and their loaded datasets) cached
+// across requests, so repeated fits over the same dataset pay neither process startup nor
+// the dataset load; only the configuration changes between fits
+class Daemon {
+public:
+    Daemon(void);
+    ~Daemon(void);
+
+    // @param socket_path: filesystem path at which the unix domain socket is created,
+    //        replacing any stale socket left behind by a previous run
+    // @returns the process exit code once the daemon shuts down
+    // @note requests are served one at a time; each request is a JSON object
+    //       { "data": <csv path>, "config": <configuration object> } terminated by the
+    //       client shutting down its write side of the connection, and the object
+    //       { "command": "shutdown" } stops the daemon
+    int serve(std::string const & socket_path);
+
+private:
+    // Fitted instances keyed by dataset path, content digest, and the configuration fields
+    // that shape the loaded dataset; each instance holds its dataset across fits
+    std::unordered_map< std::string, std::unique_ptr< GOSDT > > instances;
+
+    // @param request: parsed fit request holding the dataset path and configuration
+    // @returns the JSON response carrying the extracted models or an error message
+    // @modifies caches the fitted instance so later requests over the same dataset reuse it
+    json dispatch(json const & request);
+
+    // @param path: filesystem path of the requested dataset
+    // @param content: raw bytes of the requested dataset
+    // @returns the cache key of the instance able to serve this request; requests whose
+    //          configuration shapes the dataset differently map to different keys
+    std::string instance_key(std::string const & path, std::string const & content) const;
+};
+
+#endif
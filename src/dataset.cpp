@@ -1,6 +1,72 @@
 #include "dataset.hpp"
 #include "state.hpp"
 
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace {
+    // On-disk layout of the binary dataset cache:
+    //   CacheHeader, the encoder schema as a json blob, zero-padding up to a block
+    //   boundary, then the raw blocks of each bitmask group in the following order:
+    //   rows, features, targets, feature_rows, target_rows
+    // The masks are in equivalence-class space, so they are followed by the per-class
+    // sample counts (groups x binary_targets), then the sample-to-class and sample-to-label
+    // maps (samples entries each), all as unsigned int
+    // Blocks are written in host byte order, so the cache is not portable across
+    // architectures; the block size is validated on load
+    unsigned int const cache_version = 2;
+    char const cache_magic[8] = { 'G', 'O', 'S', 'D', 'T', 'B', 'I', 'N' };
+    struct CacheHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int block_bytes;
+        unsigned long long content_hash;
+        unsigned int samples;
+        unsigned int groups;
+        unsigned int binary_features;
+        unsigned int binary_targets;
+        unsigned long long schema_bytes;
+    };
+
+    // 64-bit FNV-1a digest of the csv content, stable across processes unlike std::hash
+    unsigned long long content_digest(std::string const & content) {
+        unsigned long long digest = 14695981039346656037ULL;
+        for (size_t i = 0; i < content.size(); ++i) {
+            digest ^= (unsigned char)(content[i]);
+            digest *= 1099511628211ULL;
+        }
+        return digest;
+    }
+
+    // @returns the number of blocks needed to store a bitmask of the given size
+    unsigned int mask_blocks(unsigned int size) {
+        unsigned int blocks, offset;
+        Bitmask::block_layout(size, & blocks, & offset);
+        return blocks;
+    }
+
+    // @returns byte_count rounded up to the next block boundary
+    size_t block_align(size_t byte_count) {
+        return (byte_count + sizeof(bitblock) - 1) / sizeof(bitblock) * sizeof(bitblock);
+    }
+
+    unsigned int const cache_line_bytes = 64;
+
+    // @returns the number of blocks needed to store a bitmask of the given size,
+    //          rounded up so consecutive masks start on separate cache lines
+    unsigned int aligned_mask_blocks(unsigned int size) {
+        unsigned int const blocks_per_line = cache_line_bytes / sizeof(bitblock);
+        return (mask_blocks(size) + blocks_per_line - 1) / blocks_per_line * blocks_per_line;
+    }
+}
+
 Dataset::Dataset(void) {}
 Dataset::~Dataset(void) {}
 
@@ -14,18 +80,90 @@ Dataset::Dataset(std::istream & data_source) { load(data_source); }
 //   The overall shape of the data set is stored for indexing later
 void Dataset::load(std::istream & data_source) {
     // Step 1: Construct all rows, features, and targets in binary form
-    construct_bitmasks(data_source);
+    // When a cache path is configured, a valid cache skips the csv parse entirely and
+    // points the bitmasks into a memory mapping of the cache file
+    if (Configuration::dataset_cache() != "") {
+        std::stringstream content_buffer;
+        content_buffer << data_source.rdbuf();
+        std::string content = content_buffer.str();
+        // The cached bitmasks and encoder schema bake in every configuration field that
+        // shapes the binarization, so those join the csv bytes in the cache key (the field
+        // set mirrors Daemon::instance_key); changing any of them misses the cache instead
+        // of silently serving a stale encoding
+        std::stringstream shaping;
+        shaping << ":" << Configuration::costs()
+            << ":" << Configuration::weights()
+            << ":" << Configuration::balance()
+            << ":" << Configuration::precision_limit()
+            << ":" << Configuration::threshold_guessing()
+            << ":" << Configuration::threshold_guessing_rounds();
+        unsigned long long content_hash = content_digest(content + shaping.str());
+        if (!load_cache(Configuration::dataset_cache(), content_hash)) {
+            std::istringstream content_stream(content);
+            construct_bitmasks(content_stream);
+            save_cache(Configuration::dataset_cache(), content_hash);
+        }
+    } else {
+        construct_bitmasks(data_source);
+    }
+
+    // Step 2: Materialize the encoder's exclusive equality blocks as feature masks
+    construct_feature_groups();
 
-    // Step 2: Initialize the cost matrix
+    // Step 3: Initialize the cost matrix
     construct_cost_matrix();
 
-    // Step 3: Build the majority and minority costs based on the cost matrix
+    // Step 4: Build the majority and minority costs based on the cost matrix
     aggregate_cost_matrix();
 
-    // Step 4: Build the majority bitmask indicating whether a point is in the majority group
+    // Step 5: Find each equivalence class's cost-minimizing label and build the weight indexes
     construct_majority();
-    
-    if (Configuration::verbose) {
+
+    // Step 6: Translate the reference model's labels into equivalence-class weights
+    construct_reference_weights();
+
+    // Step 7: Fuse the per-class weight views read by every summary into one index
+    construct_summary_index();
+
+    // Step 8: Precompute pairwise feature distances for the similar support bound
+    construct_distance_index();
+
+    if (Configuration::verbose()) {
+        std::cout << "Dataset Dimensions: " << height() << " x " << width() << " x " << depth() << std::endl;
+    }
+    return;
+}
+
+// Loads a dataset that is already binarized, straight from a row-major byte matrix
+// The csv parse and the dataset cache are both bypassed; the bitmasks are built
+// directly from the matrix and the remaining steps match the csv path
+void Dataset::load(unsigned char const * matrix, unsigned int samples, unsigned int columns) {
+    // Step 1: Construct all rows, features, and targets in binary form
+    this -> encoder = Encoder(matrix, samples, columns);
+    construct_bitmasks();
+
+    // Step 2: Materialize the encoder's exclusive equality blocks as feature masks
+    construct_feature_groups();
+
+    // Step 3: Initialize the cost matrix
+    construct_cost_matrix();
+
+    // Step 4: Build the majority and minority costs based on the cost matrix
+    aggregate_cost_matrix();
+
+    // Step 5: Find each equivalence class's cost-minimizing label and build the weight indexes
+    construct_majority();
+
+    // Step 6: Translate the reference model's labels into equivalence-class weights
+    construct_reference_weights();
+
+    // Step 7: Fuse the per-class weight views read by every summary into one index
+    construct_summary_index();
+
+    // Step 8: Precompute pairwise feature distances for the similar support bound
+    construct_distance_index();
+
+    if (Configuration::verbose()) {
         std::cout << "Dataset Dimensions: " << height() << " x " << width() << " x " << depth() << std::endl;
     }
     return;
@@ -43,55 +181,312 @@ void Dataset::clear(void) {
     this -> max_costs.clear();
     this -> min_costs.clear();
     this -> diff_costs.clear();
-    this -> majority = Bitmask();
+    this -> distances.clear();
+    this -> exclusion_blocks.clear();
+    this -> feature_exclusions.clear();
+    this -> group_counts.clear();
+    this -> group_minimizers.clear();
+    this -> sample_groups.clear();
+    this -> sample_labels.clear();
+    this -> sample_weights.clear();
+    this -> group_weights.clear();
+    this -> reference_weights.clear();
+    this -> _total_weight = 0.0;
+    this -> target_weights = Index();
+    this -> summary_weights = Index();
+    this -> total_weights = Index();
+    release_cache();
+    if (this -> matrix_storage != NULL) { // Safe now that all views into the storage are cleared
+        free(this -> matrix_storage);
+        this -> matrix_storage = NULL;
+        this -> matrix_blocks = 0;
+    }
 }
 
 void Dataset::construct_bitmasks(std::istream & data_source) {
     this -> encoder = Encoder(data_source);
-    std::vector< Bitmask > rows = this -> encoder.read_binary_rows();
+    construct_bitmasks();
+}
+
+// Builds the column-major and row-major bitmask views from the binary rows already
+// produced by the encoder, regardless of which source the encoder was built from
+// Identical feature rows are collapsed into weighted equivalence classes first, so every
+// downstream kernel scales with the number of distinct rows instead of raw sample count
+void Dataset::construct_bitmasks(void) {
     unsigned int number_of_samples = this -> encoder.samples(); // Number of samples in the dataset
-    unsigned int number_of_rows = 0; // Number of samples after compressions
     unsigned int number_of_binary_features = this -> encoder.binary_features(); // Number of source features
     unsigned int number_of_binary_targets = this -> encoder.binary_targets(); // Number of target features
     this -> _size = number_of_samples;
 
-    this -> rows = this -> encoder.read_binary_rows();
+    std::vector< Bitmask > sample_rows = this -> encoder.read_binary_rows();
 
-    this -> features.resize(number_of_binary_features, number_of_samples);
-    this -> feature_rows.resize(number_of_samples, number_of_binary_features);
-    this -> targets.resize(number_of_binary_targets, number_of_samples);
-    this -> target_rows.resize(number_of_samples, number_of_binary_targets);
+    // Group samples by feature pattern; classes are numbered in first-occurrence order
+    std::unordered_map< Bitmask, unsigned int > patterns;
+    std::vector< unsigned int > representatives;
+    this -> sample_groups.resize(number_of_samples);
+    this -> sample_labels.resize(number_of_samples);
+    Bitmask pattern(number_of_binary_features);
+    for (unsigned int i = 0; i < number_of_samples; ++i) {
+        for (unsigned int j = 0; j < number_of_binary_features; ++j) { pattern.set(j, bool(sample_rows[i][j])); }
+        auto insertion = patterns.insert(std::make_pair(pattern, (unsigned int)(representatives.size())));
+        if (insertion.second) { representatives.push_back(i); }
+        this -> sample_groups[i] = insertion.first -> second;
+        this -> sample_labels[i] = sample_rows[i].scan(number_of_binary_features, true) - number_of_binary_features;
+    }
+    unsigned int number_of_groups = representatives.size();
 
+    // Per-class sample frequencies of each equivalence class; these weights carry the
+    // multiplicities lost by the collapse
+    this -> group_counts.assign((size_t)(number_of_groups) * number_of_binary_targets, 0);
     for (unsigned int i = 0; i < number_of_samples; ++i) {
-        for (unsigned int j = 0; j < number_of_binary_features; ++j) {
-            this -> features[j].set(i, bool(rows[i][j]));
-            this -> feature_rows[i].set(j, bool(rows[i][j]));
+        this -> group_counts[(size_t)(this -> sample_groups[i]) * number_of_binary_targets + this -> sample_labels[i]] += 1;
+    }
+
+    this -> rows.resize(number_of_groups, number_of_binary_features + number_of_binary_targets);
+    this -> features.resize(number_of_binary_features, number_of_groups);
+    this -> feature_rows.resize(number_of_groups, number_of_binary_features);
+    this -> targets.resize(number_of_binary_targets, number_of_groups);
+    this -> target_rows.resize(number_of_groups, number_of_binary_targets);
+
+    // Each column-major mask is owned by exactly one column task and each row-major mask
+    // by exactly one row task, so both transpositions populate in parallel without sharing
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, number_of_binary_features + number_of_binary_targets), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int j = range.begin(); j != range.end(); ++j) {
+            if (j < number_of_binary_features) {
+                for (unsigned int g = 0; g < number_of_groups; ++g) {
+                    this -> features[j].set(g, bool(sample_rows[representatives[g]][j]));
+                }
+            } else {
+                unsigned int t = j - number_of_binary_features;
+                for (unsigned int g = 0; g < number_of_groups; ++g) {
+                    this -> targets[t].set(g, this -> group_counts[(size_t)(g) * number_of_binary_targets + t] > 0);
+                }
+            }
         }
-        for (unsigned int j = 0; j < number_of_binary_targets; ++j) {
-            this -> targets[j].set(i, bool(rows[i][number_of_binary_features + j]));
-            this -> target_rows[i].set(j, bool(rows[i][number_of_binary_features + j]));
+    });
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, number_of_groups), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int g = range.begin(); g != range.end(); ++g) {
+            for (unsigned int j = 0; j < number_of_binary_features; ++j) {
+                bool const bit = bool(sample_rows[representatives[g]][j]);
+                this -> feature_rows[g].set(j, bit);
+                this -> rows[g].set(j, bit);
+            }
+            for (unsigned int j = 0; j < number_of_binary_targets; ++j) {
+                bool const present = this -> group_counts[(size_t)(g) * number_of_binary_targets + j] > 0;
+                this -> target_rows[g].set(j, present);
+                this -> rows[g].set(number_of_binary_features + j, present);
+            }
         }
+    });
+    this -> shape = std::tuple< int, int, int >(number_of_groups, this -> features.size(), this -> targets.size());
+    construct_group_weights();
+    pack_bitmasks();
+    if (Configuration::verbose() && number_of_groups < number_of_samples) {
+        std::cout << "Collapsed " << number_of_samples << " samples into " << number_of_groups << " equivalence classes" << std::endl;
     }
-    this -> shape = std::tuple< int, int, int >(this -> rows.size(), this -> features.size(), this -> targets.size());
 };
 
+void Dataset::pack_bitmasks(void) {
+    std::vector< Bitmask > * const groups[] = {
+        & this -> rows, & this -> features, & this -> targets, & this -> feature_rows, & this -> target_rows
+    };
+    size_t total = 0;
+    for (auto group : groups) {
+        for (Bitmask const & mask : * group) { total += aligned_mask_blocks(mask.size()); }
+    }
+    if (total == 0) { return; }
+    bitblock * storage = (bitblock *) aligned_alloc(cache_line_bytes, total * sizeof(bitblock));
+    if (storage == NULL) { return; } // Fall back to the independently allocated masks
+    this -> matrix_storage = storage;
+    this -> matrix_blocks = total;
+
+    // Repack each group into one contiguous run so scans over consecutive masks walk
+    // sequential cache lines instead of chasing pointers across the heap
+    bitblock * cursor = storage;
+    for (auto group : groups) {
+        for (Bitmask & mask : * group) {
+            if (mask.size() == 0) { continue; }
+            unsigned int used = mask_blocks(mask.size());
+            unsigned int aligned = aligned_mask_blocks(mask.size());
+            memcpy(cursor, mask.data(), used * sizeof(bitblock));
+            for (unsigned int b = used; b < aligned; ++b) { cursor[b] = 0; }
+            mask.attach(cursor, mask.size());
+            cursor += aligned;
+        }
+    }
+}
+
+bool Dataset::load_cache(std::string const & path, unsigned long long content_hash) {
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) { return false; }
+    struct stat file_info;
+    if (fstat(descriptor, & file_info) != 0 || (size_t)(file_info.st_size) < sizeof(CacheHeader)) {
+        close(descriptor);
+        return false;
+    }
+    size_t length = file_info.st_size;
+    void * mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) { return false; }
+
+    CacheHeader header;
+    memcpy(& header, mapping, sizeof(CacheHeader));
+    if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0
+        || header.version != cache_version
+        || header.block_bytes != sizeof(bitblock)
+        || header.content_hash != content_hash
+        || sizeof(CacheHeader) + header.schema_bytes > length) {
+        munmap(mapping, length);
+        return false;
+    }
+
+    unsigned int number_of_samples = header.samples;
+    unsigned int number_of_groups = header.groups;
+    unsigned int number_of_binary_features = header.binary_features;
+    unsigned int number_of_binary_targets = header.binary_targets;
+
+    // Validate the payload length before attaching any bitmasks to the mapping
+    // The masks are in equivalence-class space; the weight and sample maps follow them
+    size_t payload_offset = block_align(sizeof(CacheHeader) + header.schema_bytes);
+    size_t payload_blocks =
+        (size_t)(number_of_groups) * mask_blocks(number_of_binary_features + number_of_binary_targets) // rows
+        + (size_t)(number_of_binary_features + number_of_binary_targets) * mask_blocks(number_of_groups) // features, targets
+        + (size_t)(number_of_groups) * mask_blocks(number_of_binary_features) // feature rows
+        + (size_t)(number_of_groups) * mask_blocks(number_of_binary_targets); // target rows
+    size_t payload_counts = (size_t)(number_of_groups) * number_of_binary_targets + 2 * (size_t)(number_of_samples);
+    if (payload_offset + payload_blocks * sizeof(bitblock) + payload_counts * sizeof(unsigned int) > length) {
+        munmap(mapping, length);
+        return false;
+    }
+
+    try {
+        char const * schema_begin = (char const *)(mapping) + sizeof(CacheHeader);
+        json schema = json::parse(schema_begin, schema_begin + header.schema_bytes);
+        this -> encoder = Encoder();
+        this -> encoder.restore(schema);
+    } catch (...) {
+        munmap(mapping, length);
+        return false;
+    }
+
+    this -> _size = number_of_samples;
+    bitblock * cursor = (bitblock *)((char *)(mapping) + payload_offset);
+
+    this -> rows.resize(number_of_groups);
+    for (unsigned int i = 0; i < number_of_groups; ++i) {
+        this -> rows[i].attach(cursor, number_of_binary_features + number_of_binary_targets);
+        cursor += mask_blocks(number_of_binary_features + number_of_binary_targets);
+    }
+    this -> features.resize(number_of_binary_features);
+    for (unsigned int j = 0; j < number_of_binary_features; ++j) {
+        this -> features[j].attach(cursor, number_of_groups);
+        cursor += mask_blocks(number_of_groups);
+    }
+    this -> targets.resize(number_of_binary_targets);
+    for (unsigned int j = 0; j < number_of_binary_targets; ++j) {
+        this -> targets[j].attach(cursor, number_of_groups);
+        cursor += mask_blocks(number_of_groups);
+    }
+    this -> feature_rows.resize(number_of_groups);
+    for (unsigned int i = 0; i < number_of_groups; ++i) {
+        this -> feature_rows[i].attach(cursor, number_of_binary_features);
+        cursor += mask_blocks(number_of_binary_features);
+    }
+    this -> target_rows.resize(number_of_groups);
+    for (unsigned int i = 0; i < number_of_groups; ++i) {
+        this -> target_rows[i].attach(cursor, number_of_binary_targets);
+        cursor += mask_blocks(number_of_binary_targets);
+    }
+
+    // The per-class weights and sample maps follow the mask payload; they are copied out
+    // since they are mutated-adjacent working vectors rather than read-only views
+    unsigned int const * counts = (unsigned int const *)(cursor);
+    this -> group_counts.assign(counts, counts + (size_t)(number_of_groups) * number_of_binary_targets);
+    counts += (size_t)(number_of_groups) * number_of_binary_targets;
+    this -> sample_groups.assign(counts, counts + number_of_samples);
+    counts += number_of_samples;
+    this -> sample_labels.assign(counts, counts + number_of_samples);
+
+    this -> shape = std::tuple< int, int, int >(number_of_groups, this -> features.size(), this -> targets.size());
+    construct_group_weights();
+    this -> cache_mapping = mapping;
+    this -> cache_length = length;
+    if (Configuration::verbose()) {
+        std::cout << "Loaded Binary Dataset Cache: " << path << std::endl;
+    }
+    return true;
+}
+
+void Dataset::save_cache(std::string const & path, unsigned long long content_hash) const {
+    json schema = json::object();
+    this -> encoder.summarize(schema);
+    std::string schema_text = schema.dump();
+
+    CacheHeader header;
+    memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = cache_version;
+    header.block_bytes = sizeof(bitblock);
+    header.content_hash = content_hash;
+    header.samples = size();
+    header.groups = height();
+    header.binary_features = width();
+    header.binary_targets = depth();
+    header.schema_bytes = schema_text.size();
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output.good()) { return; } // A failed cache write only costs startup time on the next fit
+
+    output.write((char const *)(& header), sizeof(CacheHeader));
+    output.write(schema_text.data(), schema_text.size());
+    size_t header_bytes = sizeof(CacheHeader) + schema_text.size();
+    char const zeros[sizeof(bitblock)] = { 0 };
+    output.write(zeros, block_align(header_bytes) - header_bytes);
+
+    std::vector< Bitmask > const * groups[] = {
+        & (this -> rows), & (this -> features), & (this -> targets), & (this -> feature_rows), & (this -> target_rows)
+    };
+    for (unsigned int g = 0; g < 5; ++g) {
+        std::vector< Bitmask > const & group = * groups[g];
+        for (unsigned int i = 0; i < group.size(); ++i) {
+            output.write((char const *)(group[i].data()), mask_blocks(group[i].size()) * sizeof(bitblock));
+        }
+    }
+
+    // The per-class sample weights and the raw-sample maps follow the masks
+    output.write((char const *)(this -> group_counts.data()), this -> group_counts.size() * sizeof(unsigned int));
+    output.write((char const *)(this -> sample_groups.data()), this -> sample_groups.size() * sizeof(unsigned int));
+    output.write((char const *)(this -> sample_labels.data()), this -> sample_labels.size() * sizeof(unsigned int));
+}
+
+void Dataset::release_cache(void) {
+    if (this -> cache_mapping != NULL) {
+        munmap(this -> cache_mapping, this -> cache_length);
+        this -> cache_mapping = NULL;
+        this -> cache_length = 0;
+    }
+}
+
 void Dataset::construct_cost_matrix(void) {
     this -> costs.resize(depth(), std::vector< float >(depth(), 0.0));
-    if (Configuration::costs != "") { // Customized cost matrix
-        std::ifstream input_stream(Configuration::costs);
+    if (Configuration::costs() != "") { // Customized cost matrix
+        std::ifstream input_stream(Configuration::costs());
         parse_cost_matrix(input_stream);
-    } else if (Configuration::balance) { // Class-balancing cost matrix
+    } else if (Configuration::balance()) { // Class-balancing cost matrix
+        std::vector< float > class_totals(depth(), 0.0); // Weight of each class, over all equivalence classes
+        for (unsigned int g = 0; g < height(); ++g) {
+            for (unsigned int j = 0; j < depth(); ++j) { class_totals[j] += this -> group_weights[(size_t)(g) * depth() + j]; }
+        }
         for (unsigned int i = 0; i < depth(); ++i) {
             for (unsigned int j = 0; j < depth(); ++j) {
                 if (i == j) { this -> costs[i][j] = 0.0; continue; }
-                this -> costs[i][j] = 1.0 / (float)(depth() * this -> targets[j].count());
+                this -> costs[i][j] = 1.0 / ((float)(depth()) * class_totals[j]);
             }
         }
     } else { // Default cost matrix
         for (unsigned int i = 0; i < depth(); ++i) {
             for (unsigned int j = 0; j < depth(); ++j) {
                 if (i == j) { this -> costs[i][j] = 0.0; continue; }
-                this -> costs[i][j] = 1.0 / (float)(height());
+                this -> costs[i][j] = 1.0 / total_weight();
             }
         }
     }
@@ -176,77 +571,204 @@ void Dataset::aggregate_cost_matrix(void) {
     }
 }
 
+// For each equivalence class, find the label that minimizes the cost of labelling the whole
+// class; the class's weight split between that label and the rest feeds the equivalent-points
+// lower bound through the fused summary index
 void Dataset::construct_majority(void) {
-    std::vector< Bitmask > keys(height(), width());
-    for (unsigned int i = 0; i < height(); ++i) {
-        for (unsigned int j = 0; j < width(); ++j) {
-            keys[i].set(j, bool(this -> rows[i][j]));
-        }
-    }
-
-    // Step 1: Construct a map from the binary features to their distributions
-    std::unordered_map< Bitmask, std::vector< float > > distributions;
-    for (unsigned int i = 0; i < height(); ++i) {
-        Bitmask const & key = keys.at(i);
-        // Initialize the map and resize the value (of type vector) to the number of unique labels
-        // This way the vector can hold the label distribution for this feature combination
-        if (distributions[key].size() < depth()) { distributions[key].resize(depth(), 0.0); }
-        for (unsigned int j = 0; j < depth(); ++j) {
-            distributions[key][j] += (float)rows[i][width() + j];
-        }
-    }
-
-    // Step 2: Construct a map from the binary features to cost minimizers
-    std::unordered_map< Bitmask, unsigned int  > minimizers;
-    for (auto it = distributions.begin(); it != distributions.end(); ++it) {
-        Bitmask const & key = it -> first;
-        std::vector< float > const & distribution = it -> second;
+    unsigned int const d = depth();
+    this -> group_minimizers.assign(height(), 0);
+    for (unsigned int g = 0; g < height(); ++g) {
+        float const * distribution = & (this -> group_weights[(size_t)(g) * d]);
         float minimum = std::numeric_limits<float>::max();
         unsigned int minimizer = 0;
-        for (unsigned int i = 0; i < depth(); ++i) {
+        for (unsigned int i = 0; i < d; ++i) {
             float cost = 0.0;
-            for (unsigned int j = 0; j < depth(); ++j) {
-                cost += this -> costs[i][j] * distribution.at(j); // Cost of predicting i when the class is j
+            for (unsigned int j = 0; j < d; ++j) {
+                cost += this -> costs[i][j] * distribution[j]; // Cost of predicting i when the class is j
             }
             if (cost < minimum) {
                 minimum = cost;
                 minimizer = i;
             }
         }
-        minimizers.emplace(key, minimizer);
+        this -> group_minimizers[g] = minimizer;
     }
+}
 
-    // Step 3: Set the bits associated with each minimizer
-    this -> majority.initialize(height());
-    for (unsigned int i = 0; i < height(); ++i) {
-        Bitmask const & key = keys.at(i);
-        unsigned int minimizer = minimizers[key];
-        unsigned int label = this -> rows[i].scan(width(), true) - width();
-        this -> majority.set(i, minimizer == label); // Set this bit true if the label matches this minimizer
+// Loads the optional per-sample importance weights; without a weights file every sample
+// weighs 1 and every weighted quantity reduces to the raw counts
+void Dataset::construct_sample_weights(void) {
+    this -> sample_weights.clear();
+    if (Configuration::weights() == "") { return; }
+    std::ifstream input_stream(Configuration::weights());
+    if (!input_stream.good()) {
+        std::cout << "File Not Found: " << Configuration::weights() << std::endl;
+        exit(1);
+    }
+    std::string line;
+    while (std::getline(input_stream, line)) {
+        if (line.empty()) { continue; }
+        this -> sample_weights.emplace_back(atof(line.c_str()));
+    }
+    if (this -> sample_weights.size() != size()) {
+        std::cout << "Expected " << size() << " sample weights but found " << this -> sample_weights.size() << ": " << Configuration::weights() << std::endl;
+        exit(1);
     }
 }
 
-float Dataset::distance(Bitmask const & set, unsigned int i, unsigned int j, unsigned int id) const {
-    Bitmask & buffer = State::locals[id].columns[0];
-    float positive_distance = 0.0, negative_distance = 0.0;
-    for (unsigned int k = 0; k < depth(); ++k) {
-        buffer = this -> features[i];
-        this -> features[j].bit_xor(buffer, false);
-        set.bit_and(buffer);
-        // this -> majority.bit_and(buffer, false);
-        this -> targets[k].bit_and(buffer);
-        positive_distance += this -> diff_costs[k] * buffer.count();
+void Dataset::construct_group_weights(void) {
+    unsigned int const d = this -> targets.size();
+    unsigned int const number_of_groups = this -> group_counts.size() / d;
+    construct_sample_weights();
 
-        buffer = this -> features[i];
-        this -> features[j].bit_xor(buffer, true);
-        set.bit_and(buffer);
-        // this -> majority.bit_and(buffer, false);
-        this -> targets[k].bit_and(buffer);
-        negative_distance += this -> diff_costs[k] * buffer.count();
+    // Fold the sample weights into per-class weights; an importance-sampled dataset that
+    // used to be emulated by row duplication becomes pure weight mass on the same classes
+    this -> group_weights.assign((size_t)(number_of_groups) * d, 0.0);
+    if (this -> sample_weights.empty()) {
+        for (size_t i = 0; i < this -> group_weights.size(); ++i) { this -> group_weights[i] = this -> group_counts[i]; }
+    } else {
+        for (unsigned int i = 0; i < size(); ++i) {
+            this -> group_weights[(size_t)(this -> sample_groups[i]) * d + this -> sample_labels[i]] += this -> sample_weights[i];
+        }
+    }
+
+    std::vector< std::vector< float > > weights(number_of_groups, std::vector< float >(d, 0.0));
+    std::vector< std::vector< float > > totals(number_of_groups, std::vector< float >(1, 0.0));
+    this -> _total_weight = 0.0;
+    for (unsigned int g = 0; g < number_of_groups; ++g) {
+        for (unsigned int j = 0; j < d; ++j) {
+            float const value = this -> group_weights[(size_t)(g) * d + j];
+            weights[g][j] = value;
+            totals[g][0] += value;
+            this -> _total_weight += value;
+        }
+    }
+    this -> target_weights = Index(weights);
+    this -> total_weights = Index(totals);
+}
+
+void Dataset::construct_reference_weights(void) {
+    if (!Configuration::reference_LB()) { return; }
+    unsigned int const d = depth();
+    this -> reference_weights.assign((size_t)(height()) * d, 0.0);
+    for (unsigned int i = 0; i < size(); ++i) {
+        unsigned int const label = this -> sample_labels[i];
+        // A sample counts as a match when the reference model assigns its true label
+        if (label < Reference::labels.size() && Reference::labels[label].get(i)) {
+            float const value = this -> sample_weights.empty() ? 1.0 : this -> sample_weights[i];
+            this -> reference_weights[(size_t)(this -> sample_groups[i]) * d + label] += value;
+        }
     }
-    return std::min(positive_distance, negative_distance);
 }
 
+// One-hot style encodings make most equality features mutually exclusive within their
+// source column's block; the masks built here let exploration drop a whole block from a
+// positive subproblem's feature set in one AND instead of rediscovering each sibling as a
+// degenerate split, one descendant vertex at a time
+void Dataset::construct_feature_groups(void) {
+    unsigned int const m = width();
+    this -> feature_exclusions.assign(m, -1);
+    this -> exclusion_blocks.clear();
+    std::vector< std::pair< unsigned int, unsigned int > > const & blocks = this -> encoder.exclusions;
+    for (unsigned int b = 0; b < blocks.size(); ++b) {
+        Bitmask mask(m, false);
+        for (unsigned int j = blocks[b].first; j < blocks[b].second && j < m; ++j) {
+            mask.set(j, true);
+            this -> feature_exclusions[j] = b;
+        }
+        this -> exclusion_blocks.emplace_back(mask);
+    }
+    if (Configuration::verbose() && this -> exclusion_blocks.size() > 0) {
+        std::cout << "Exclusive Equality Blocks: " << this -> exclusion_blocks.size() << std::endl;
+    }
+}
+
+void Dataset::exclude_siblings(unsigned int feature_index, Bitmask & feature_set) const {
+    int const block = this -> feature_exclusions[feature_index];
+    if (block < 0) { return; }
+    this -> exclusion_blocks[block].bit_and(feature_set, true); // Conjunction with the block's complement
+}
+
+// The three per-class quantities a summary reads (class weights, the weight agreeing with the
+// class's cost minimizer, and the weight the reference model labels correctly) are always
+// summed over the same capture mask, so they are stored side by side in one Index and the mask
+// is scanned once instead of once per quantity
+void Dataset::construct_summary_index(void) {
+    unsigned int const d = depth();
+    bool const use_reference = Configuration::reference_LB();
+    unsigned int const span = use_reference ? 3 * d : 2 * d;
+    std::vector< std::vector< float > > fused(height(), std::vector< float >(span, 0.0));
+    for (unsigned int g = 0; g < height(); ++g) {
+        float const * values = & (this -> group_weights[(size_t)(g) * d]);
+        unsigned int const minimizer = this -> group_minimizers[g];
+        for (unsigned int j = 0; j < d; ++j) { fused[g][j] = values[j]; }
+        fused[g][d + minimizer] = values[minimizer]; // Weight of the samples that agree with the class's minimizer
+        if (use_reference) {
+            float const * matches = & (this -> reference_weights[(size_t)(g) * d]);
+            for (unsigned int j = 0; j < d; ++j) { fused[g][2 * d + j] = matches[j]; }
+        }
+    }
+    this -> summary_weights = Index(fused);
+}
+
+void Dataset::construct_distance_index(void) {
+    if (!Configuration::similar_support()) { return; }
+    unsigned int const m = width();
+    this -> maximum_difference = 0.0;
+    for (unsigned int k = 0; k < depth(); ++k) {
+        this -> maximum_difference = std::max(this -> maximum_difference, this -> diff_costs[k]);
+    }
+    this -> distances.resize(m * m, 0.0);
+    // Each unordered pair is computed once and mirrored; the columns are contiguous, so
+    // one row of pairs streams feature i against every later feature
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, m), [this, m](tbb::blocked_range< unsigned int > const & range) {
+        unsigned int const d = depth();
+        Bitmask disagreement(height());
+        Bitmask agreement(height());
+        std::vector< float > disagreement_weights(d), agreement_weights(d);
+        for (unsigned int i = range.begin(); i != range.end(); ++i) {
+            for (unsigned int j = i + 1; j < m; ++j) {
+                disagreement = this -> features[i];
+                this -> features[j].bit_xor(disagreement, false);
+                agreement = this -> features[i];
+                this -> features[j].bit_xor(agreement, true);
+                std::fill(disagreement_weights.begin(), disagreement_weights.end(), 0.0);
+                std::fill(agreement_weights.begin(), agreement_weights.end(), 0.0);
+                this -> target_weights.sum(disagreement, disagreement_weights.data());
+                this -> target_weights.sum(agreement, agreement_weights.data());
+                float positive_distance = 0.0, negative_distance = 0.0;
+                for (unsigned int k = 0; k < d; ++k) {
+                    positive_distance += this -> diff_costs[k] * disagreement_weights[k];
+                    negative_distance += this -> diff_costs[k] * agreement_weights[k];
+                }
+                float const value = std::min(positive_distance, negative_distance);
+                this -> distances[i * m + j] = value;
+                this -> distances[j * m + i] = value;
+            }
+        }
+    });
+}
+
+float Dataset::distance(Bitmask const & set, unsigned int i, unsigned int j, unsigned int id) const {
+    // The precomputed full-set distance already bounds the captured-set distance; one weighted
+    // count over the captured disagreement set refines it per vertex, instead of the per-class
+    // scans the on-the-fly computation needed
+    Bitmask & buffer = State::locals()[id].columns[0];
+    buffer = this -> features[i];
+    this -> features[j].bit_xor(buffer, false);
+    set.bit_and(buffer, false);
+    float const refined = this -> maximum_difference * weight(buffer);
+    return std::min(this -> distances[i * width() + j], refined);
+}
+
+float Dataset::weight(Bitmask const & capture_set) const {
+    float total = 0.0;
+    this -> total_weights.sum(capture_set, & total);
+    return total;
+}
+
+float Dataset::total_weight(void) const { return this -> _total_weight; }
+
 // @param feature_index: selects the feature on which to split
 // @param positive: determines whether to provide the subset that tests positive on the feature or tests negative on the feature
 // @param set: pointer to bit blocks which indicate the original set before splitting
@@ -255,35 +777,40 @@ float Dataset::distance(Bitmask const & set, unsigned int i, unsigned int j, uns
 void Dataset::subset(unsigned int feature_index, bool positive, Bitmask & set) const {
     // Performs bit-wise and between feature and set with possible bit-flip if performing negative test
     this -> features[feature_index].bit_and(set, !positive);
-    if (Configuration::depth_budget != 0){ set.set_depth_budget(set.get_depth_budget()-1);} //subproblems have one less depth_budget than their parent
+    if (Configuration::depth_budget() != 0){ set.set_depth_budget(set.get_depth_budget()-1);} //subproblems have one less depth_budget than their parent
 }
 
 void Dataset::subset(unsigned int feature_index, Bitmask & negative, Bitmask & positive) const {
     // Performs bit-wise and between feature and set with possible bit-flip if performing negative test
     this -> features[feature_index].bit_and(negative, true);
     this -> features[feature_index].bit_and(positive, false);
-    if (Configuration::depth_budget != 0){
+    if (Configuration::depth_budget() != 0){
         negative.set_depth_budget(negative.get_depth_budget()-1);
         positive.set_depth_budget(positive.get_depth_budget()-1);
     } //subproblems have one less depth_budget than their parent
 }
 
 void Dataset::summary(Bitmask const & capture_set, float & info, float & potential, float & min_loss, float & guaranteed_min_loss, float & max_loss, unsigned int & target_index, unsigned int id) const {
-    Bitmask & buffer = State::locals[id].columns[0];
-    unsigned int * distribution; // The frequencies of each class
-    distribution = (unsigned int *) alloca(sizeof(unsigned int) * depth());
-    for (int j = depth(); --j >= 0;) {
-        buffer = capture_set; // Set representing the captured points
-        this -> targets.at(j).bit_and(buffer); // Captured points with label j
-        distribution[j] = buffer.count(); // Calculate frequency
-    }
+    State::locals()[id].tally_summaries += 1;
+    unsigned int const d = depth();
+
+    // Weighted class sums over the captured equivalence classes; each entry carries the
+    // importance weight of the raw samples collapsed into the captured classes, so the
+    // arithmetic below matches what the uncollapsed, unweighted dataset would have produced
+    // The fused index recovers every per-class quantity from one pass over the capture mask
+    unsigned int const span = Configuration::reference_LB() ? 3 * d : 2 * d;
+    float * accumulators = (float *) alloca(sizeof(float) * span);
+    for (int j = span; --j >= 0;) { accumulators[j] = 0.0; }
+    this -> summary_weights.sum(capture_set, accumulators);
+    float * distribution = accumulators; // The frequencies of each class
+    float * majorities = accumulators + d; // The frequencies of points matching their class's cost minimizer
 
     float min_cost = std::numeric_limits<float>::max();
     unsigned int cost_minimizer = 0;
 
-    for (int i = depth(); --i >= 0;) { // Prediction index
+    for (int i = d; --i >= 0;) { // Prediction index
         float cost = 0.0; // accumulator for the cost of making this prediction
-        for (int j = depth(); --j >= 0;) { // Class index
+        for (int j = d; --j >= 0;) { // Class index
             cost += this -> costs.at(i).at(j) * distribution[j]; // cost of prediction-class combination
         }
         if (cost < min_cost) { // track the prediction that minimizes cost
@@ -291,25 +818,22 @@ void Dataset::summary(Bitmask const & capture_set, float & info, float & potenti
             cost_minimizer = i;
         }
     }
+    float total = 0.0;
+    for (int j = d; --j >= 0;) { total += distribution[j]; }
     float max_cost_reduction = 0.0;
-    float support = (float)(capture_set.count()) / (float)(height());
+    float support = total / total_weight();
     float information = 0.0;
 
     //calculate equivalent point loss for this capture set
     float equivalent_point_loss = 0.0;
-    for (int j = depth(); --j >= 0;) { // Class index
+    for (int j = d; --j >= 0;) { // Class index
         // maximum cost difference across predictions
         max_cost_reduction += this -> diff_costs[j] * distribution[j];
 
-        buffer = capture_set; // Set representing the captured points
-        this -> majority.bit_and(buffer, false); // Captured majority points
-        this -> targets.at(j).bit_and(buffer); // Captured majority points with label j
-        equivalent_point_loss += this -> match_costs[j] * buffer.count(); // Calculate frequency
-
-        buffer = capture_set; // Set representing the captured points
-        this -> majority.bit_and(buffer, true); // Captured minority points
-        this -> targets.at(j).bit_and(buffer); // Captured minority points with label j
-        equivalent_point_loss += this -> mismatch_costs[j] * buffer.count(); // Calculate frequency
+        // Captured points labelled with their class's cost minimizer count as majority points,
+        // the remainder as minority points
+        equivalent_point_loss += this -> match_costs[j] * majorities[j];
+        equivalent_point_loss += this -> mismatch_costs[j] * (distribution[j] - majorities[j]);
 
         float prob = distribution[j];
         if (prob > 0) { information += support * prob * (log(prob) - log(support)); }
@@ -328,24 +852,20 @@ void Dataset::summary(Bitmask const & capture_set, float & info, float & potenti
     }
 
 
-    if (Configuration::reference_LB){
+    if (Configuration::reference_LB()){
     //calculate reference model's error on this capture set, use as estimate for min_loss (possible overestimate)
+        float * matches = accumulators + 2 * d; // The frequencies of points the reference model labels correctly
         float reference_model_loss = 0.0;
-        for (int j = depth(); --j >= 0;) {
+        for (int j = d; --j >= 0;) {
             // maximum cost difference across predictions
             max_cost_reduction += this -> diff_costs[j] * distribution[j];
 
-            buffer = capture_set; // Set representing the captured points
-            this -> targets.at(j).bit_and(buffer, false); // Captured points with label j
-            Reference::labels[j].bit_and(buffer); // Captured points with label j classified correctly by reference model
-            reference_model_loss += this -> match_costs[j] * buffer.count(); // Calculate cost from correct classifications on j
-
-            buffer = capture_set; // Set representing the captured points
-            this -> targets.at(j).bit_and(buffer, false); // Captured points with label j
-            Reference::labels[j].bit_and(buffer, true); // Captured points with label j classified incorrectly by reference model
-            reference_model_loss += this -> mismatch_costs[j] * buffer.count(); // Calculate frequency  
+            // Captured points with label j classified correctly by the reference model
+            reference_model_loss += this -> match_costs[j] * matches[j];
+            // Captured points with label j classified incorrectly by the reference model
+            reference_model_loss += this -> mismatch_costs[j] * (distribution[j] - matches[j]);
         }
-        min_loss = reference_model_loss; 
+        min_loss = reference_model_loss;
     } else {
         // when not using a reference model, we do not want min_loss to be an overestimate
         // so we set min_loss to match guaranteed_min_loss
@@ -358,11 +878,250 @@ void Dataset::summary(Bitmask const & capture_set, float & info, float & potenti
     target_index = cost_minimizer;
 }
 
+void Dataset::summarize_all(Bitmask const & capture_set, Bitmask const & feature_set,
+    std::vector< SplitSummary > & negatives, std::vector< SplitSummary > & positives, unsigned int id) const {
+    // Dispatch to a kernel compiled with the class count as a constant when the count is
+    // small; the accumulation loops over classes then unroll instead of branching per class
+    switch (depth()) {
+        case 2: summarize_all_kernel< 2 >(capture_set, feature_set, negatives, positives, id); break;
+        case 3: summarize_all_kernel< 3 >(capture_set, feature_set, negatives, positives, id); break;
+        case 4: summarize_all_kernel< 4 >(capture_set, feature_set, negatives, positives, id); break;
+        default: summarize_all_kernel< 0 >(capture_set, feature_set, negatives, positives, id); break;
+    }
+}
+
+template < unsigned int D >
+void Dataset::summarize_all_kernel(Bitmask const & capture_set, Bitmask const & feature_set,
+    std::vector< SplitSummary > & negatives, std::vector< SplitSummary > & positives, unsigned int id) const {
+    State::locals()[id].tally_summaries += 1;
+    unsigned int const m = width();
+    unsigned int const d = (D != 0) ? D : depth();
+    bool const use_reference = Configuration::reference_LB();
+    if (negatives.size() < m) { negatives.resize(m); }
+    if (positives.size() < m) { positives.resize(m); }
+
+    // Per-(feature, class) weight accumulators for the positive side of each split, plus the
+    // raw sample supports used for structural decisions
+    // The negative side is recovered by subtracting from the capture-set totals
+    std::vector< float > positive_counts(m * d, 0.0);
+    std::vector< float > positive_majorities(m * d, 0.0);
+    std::vector< float > positive_matches;
+    if (use_reference) { positive_matches.resize(m * d, 0.0); }
+    std::vector< unsigned int > positive_supports(m, 0);
+    std::vector< float > totals(d, 0.0);
+    std::vector< float > majority_totals(d, 0.0);
+    std::vector< float > match_totals(d, 0.0);
+    unsigned int total_support = 0;
+
+    unsigned int row_blocks, row_offset;
+    Bitmask::block_layout(m, & row_blocks, & row_offset);
+    bitblock const * select = feature_set.data();
+
+    // Single pass over the captured equivalence classes, walking each row-major feature mask
+    // once; every class contributes its full per-class weights, so the accumulated sums match
+    // what a pass over the raw samples would have produced
+    for (int g_begin = 0, g_end = 0; capture_set.scan_range(true, g_begin, g_end); g_begin = g_end) {
+        for (int g = g_begin; g < g_end; ++g) {
+            unsigned int const * counts = & (this -> group_counts[(size_t)(g) * d]);
+            float const * values = & (this -> group_weights[(size_t)(g) * d]);
+            unsigned int const minimizer = this -> group_minimizers[g];
+            float const * matches = use_reference ? & (this -> reference_weights[(size_t)(g) * d]) : NULL;
+            unsigned int group_support = 0;
+            for (int c = d; --c >= 0;) {
+                group_support += counts[c];
+                totals[c] += values[c];
+                if (use_reference) { match_totals[c] += matches[c]; }
+            }
+            majority_totals[minimizer] += values[minimizer];
+            total_support += group_support;
+
+            bitblock const * row = this -> feature_rows.at(g).data();
+            for (unsigned int w = 0; w < row_blocks; ++w) {
+                bitblock bits = row[w] & select[w];
+                while (bits != 0) {
+                    unsigned int j = w * Bitmask::bits_per_block + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    for (int c = d; --c >= 0;) {
+                        positive_counts[j * d + c] += values[c];
+                        if (use_reference) { positive_matches[j * d + c] += matches[c]; }
+                    }
+                    positive_majorities[j * d + minimizer] += values[minimizer];
+                    positive_supports[j] += group_support;
+                }
+            }
+        }
+    }
+
+    // Derive the summary of each side of each candidate split from the accumulated sums
+    float * distribution = (float *) alloca(sizeof(float) * d);
+    for (int j_begin = 0, j_end = 0; feature_set.scan_range(true, j_begin, j_end); j_begin = j_end) {
+        for (int j = j_begin; j < j_end; ++j) {
+            for (unsigned int side = 0; side < 2; ++side) {
+                SplitSummary & result = side ? positives.at(j) : negatives.at(j);
+                unsigned int support_count = side ? positive_supports[j] : total_support - positive_supports[j];
+                float weight_total = 0.0;
+                float equivalent_point_loss = 0.0;
+                float reference_model_loss = 0.0;
+                for (int c = d; --c >= 0;) {
+                    float count = side ? positive_counts[j * d + c] : totals[c] - positive_counts[j * d + c];
+                    float majority_count = side ? positive_majorities[j * d + c] : majority_totals[c] - positive_majorities[j * d + c];
+                    distribution[c] = count;
+                    weight_total += count;
+                    equivalent_point_loss += this -> match_costs[c] * majority_count;
+                    equivalent_point_loss += this -> mismatch_costs[c] * (count - majority_count);
+                    if (use_reference) {
+                        float match_count = side ? positive_matches[j * d + c] : match_totals[c] - positive_matches[j * d + c];
+                        reference_model_loss += this -> match_costs[c] * match_count;
+                        reference_model_loss += this -> mismatch_costs[c] * (count - match_count);
+                    }
+                }
+
+                float min_cost = std::numeric_limits<float>::max();
+                unsigned int cost_minimizer = 0;
+                for (int i = d; --i >= 0;) { // Prediction index
+                    float cost = 0.0;
+                    for (int c = d; --c >= 0;) { cost += this -> costs.at(i).at(c) * distribution[c]; }
+                    if (cost < min_cost) {
+                        min_cost = cost;
+                        cost_minimizer = i;
+                    }
+                }
+
+                float max_cost_reduction = 0.0;
+                float support = weight_total / total_weight();
+                float information = 0.0;
+                for (int c = d; --c >= 0;) {
+                    max_cost_reduction += this -> diff_costs[c] * distribution[c];
+                    float prob = distribution[c];
+                    if (prob > 0) { information += support * prob * (log(prob) - log(support)); }
+                }
+                // summary() re-accumulates the cost differences in its reference branch, so match it
+                if (use_reference) { max_cost_reduction *= 2; }
+
+                result.guaranteed_min_loss = std::min(equivalent_point_loss, min_cost);
+                result.min_loss = use_reference ? reference_model_loss : result.guaranteed_min_loss;
+                result.max_loss = min_cost;
+                result.potential = max_cost_reduction;
+                result.info = information;
+                result.target_index = cost_minimizer;
+                result.support = support_count;
+            }
+        }
+    }
+}
+
 // Assume that data is already of the right size
-void Dataset::tile(Bitmask const & capture_set, Bitmask const & feature_set, Tile & tile, std::vector< int > & order, unsigned int id) const {
-    tile.content() = capture_set;
-    tile.width(0);
-    return;
+namespace {
+    // Upper limit on the number of bits in a canonical tile; beyond this budget the raw
+    // capture mask is a cheaper key, since the linearization cost is paid on every visit
+    // while large subproblems rarely coincide anyway
+    size_t const canonical_tile_limit = 1 << 16;
+}
+
+void Dataset::tile(Bitmask const & capture_set, Bitmask const & feature_set, Tile & tile, shared_translation & order, unsigned int id) const {
+    unsigned int const d = depth();
+    unsigned int const active = feature_set.count();
+
+    // The canonical form pairs captured classes positionally and drops their identities, so
+    // it is only sound when every sample carries the same weight and no per-sample state
+    // (reference labels, depth budgets) rides on the capture mask
+    bool eligible = Configuration::canonical_tiles()
+        && !Configuration::reference_LB()
+        && Configuration::depth_budget() == 0
+        && this -> sample_weights.empty()
+        && (size_t)(active) * capture_set.count() <= canonical_tile_limit;
+
+    // Captured equivalence classes and the total count of raw samples they represent
+    thread_local std::vector< unsigned int > captured;
+    unsigned int expanded = 0;
+    size_t content_bits = 0;
+    if (eligible) {
+        captured.clear();
+        for (int g_begin = 0, g_end = 0; capture_set.scan_range(true, g_begin, g_end); g_begin = g_end) {
+            for (int g = g_begin; g < g_end; ++g) {
+                captured.push_back(g);
+                unsigned int const * counts = & (this -> group_counts[(size_t)(g) * d]);
+                for (int c = d; --c >= 0;) { expanded += counts[c]; }
+            }
+        }
+        // The content holds one block-padded column per active feature over the captured
+        // classes, then the per-class label counts in unary, which carry the multiplicities
+        // distinguishing subproblems whose class-space submatrices coincide but represent
+        // different samples
+        size_t const words = (captured.size() + Bitmask::bits_per_block - 1) / Bitmask::bits_per_block;
+        content_bits = (size_t)(active) * words * Bitmask::bits_per_block + expanded + (size_t)(captured.size()) * d;
+        eligible = content_bits <= canonical_tile_limit;
+    }
+
+    if (!eligible) {
+        tile.content() = capture_set;
+        tile.width(0);
+        order = shared_translation(); // The null handle denotes the identity
+        return;
+    }
+    unsigned int const classes = captured.size();
+    unsigned int const words = (classes + Bitmask::bits_per_block - 1) / Bitmask::bits_per_block;
+
+    // Materialize each active feature's captured column once as packed blocks, so the sort
+    // below compares whole blocks instead of rescanning individual bits
+    thread_local std::vector< int > ranked;
+    thread_local std::vector< bitblock > column_words;
+    ranked.clear();
+    for (int j_begin = 0, j_end = 0; feature_set.scan_range(true, j_begin, j_end); j_begin = j_end) {
+        for (int j = j_begin; j < j_end; ++j) { ranked.push_back(j); }
+    }
+    column_words.clear();
+    column_words.resize((size_t)(active) * words, 0);
+    for (unsigned int k = 0; k < active; ++k) {
+        Bitmask const & column = this -> features[ranked[k]];
+        bitblock * packed = & column_words[(size_t)(k) * words];
+        for (unsigned int p = 0; p < classes; ++p) {
+            if (column.get(captured[p])) { packed[p / Bitmask::bits_per_block] |= (bitblock)(1) << (p % Bitmask::bits_per_block); }
+        }
+    }
+
+    // Sorting the active features by their captured column content erases the column order,
+    // which is the degree of freedom separating permutation-equivalent subproblems; any
+    // total order that is a function of the column content alone yields one canonical form
+    thread_local std::vector< unsigned int > slots;
+    slots.clear();
+    for (unsigned int k = 0; k < active; ++k) { slots.push_back(k); }
+    std::sort(slots.begin(), slots.end(), [words](unsigned int left, unsigned int right) {
+        bitblock const * left_column = & column_words[(size_t)(left) * words];
+        bitblock const * right_column = & column_words[(size_t)(right) * words];
+        for (unsigned int w = 0; w < words; ++w) {
+            if (left_column[w] != right_column[w]) { return left_column[w] < right_column[w]; }
+        }
+        // Columns identical over the capture are interchangeable as splits of this
+        // subproblem, so any deterministic tie break yields a valid translation
+        return ranked[left] < ranked[right];
+    });
+
+    Bitmask content(content_bits, false);
+    for (unsigned int k = 0; k < active; ++k) {
+        memcpy(content.data() + (size_t)(k) * words, & column_words[(size_t)(slots[k]) * words], words * sizeof(bitblock));
+    }
+    // One unary run of sample counts per label per class, each closed by a zero; the section
+    // is self-delimiting, so equal contents always agree on where the feature columns end
+    size_t cursor = (size_t)(active) * words * Bitmask::bits_per_block;
+    for (unsigned int p = 0; p < classes; ++p) {
+        unsigned int const * counts = & (this -> group_counts[(size_t)(captured[p]) * d]);
+        for (unsigned int c = 0; c < d; ++c) {
+            for (unsigned int k = 0; k < counts[c]; ++k) { content.set(cursor + k, true); }
+            cursor += counts[c] + 1;
+        }
+    }
+
+    // The translation maps each canonical column position back to the index this problem
+    // stores there, which model extraction composes to undo the reordering; equal orderings
+    // intern to one shared copy instead of being copied into every vertex that uses them
+    thread_local translation_type ordering;
+    ordering.resize(active + d);
+    for (unsigned int k = 0; k < active; ++k) { ordering[k] = ranked[slots[k]]; }
+    for (unsigned int c = 0; c < d; ++c) { ordering[active + c] = (int)(width() + c); }
+    order = Graph::translation(ordering);
+    tile.content(content);
+    tile.width(classes);
 }
 
 
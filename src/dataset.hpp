@@ -28,6 +28,19 @@ class Dataset;
 
 using json = nlohmann::json;
 
+// Aggregated statistics for one side of a candidate split
+// Mirrors the quantities produced by Dataset::summary without rescanning the capture set
+// All losses are importance-weighted when a weights file is configured; support stays raw
+struct SplitSummary {
+    float info; // The alkaike information critierion of this subset w.r.t the target distribution
+    float potential; // The maximum reduction in loss if all equivalent classes are relabelled
+    float min_loss; // Estimate of the minimal loss (matches guaranteed_min_loss unless Configuration::reference_LB())
+    float guaranteed_min_loss; // The minimal loss incurred if all equivalent classes are optimally labelled
+    float max_loss; // The loss incurred if the subset is left unsplit and the best single label is chosen
+    unsigned int target_index; // The label to choose if left unsplit
+    unsigned int support; // The number of raw samples in this subset, summed over captured equivalence classes
+};
+
 // Contain the dataset and any preprocessed values
 class Dataset {
 public:
@@ -42,14 +55,23 @@ public:
 
     // @modifies loads data from data stream
     void load(std::istream & data_source);
-    
+
+    // @param matrix: row-major samples x columns matrix of bytes where the first
+    //   columns - 1 entries of each row are 0/1 feature indicators and the last entry
+    //   is the class label
+    // @modifies loads the already-binarized data without any csv serialization or parse
+    // @note the matrix is only read during this call and need not outlive it
+    void load(unsigned char const * matrix, unsigned int samples, unsigned int columns);
+
     // @modifies resets dataset to initial state
     void clear(void);
 
     // @returns the sample size of the data set
     unsigned int size(void) const;
-    // @returns the physical number of rows needed to represent the data set
-    unsigned int height(void) const; 
+    // @returns the number of equivalence classes (distinct feature rows) representing the data set
+    // @note capture sets and all other row-indexed bitmasks carry one bit per equivalence
+    //       class, not one bit per raw sample; per-class sample weights recover the raw counts
+    unsigned int height(void) const;
     // @returns the number of binary non-target features used to represent the data set
     unsigned int width(void) const;
     // @returns the number of unique target values in the dataset
@@ -66,6 +88,16 @@ public:
     // @modifies target_index: The label to choose if left unsplit
     void summary(Bitmask const & capture_set, float & info, float & potential, float & min_loss, float & guaranteed_min_loss, float & max_loss, unsigned int & target_index, unsigned int id) const;
 
+    // @param capture_set: The indicator for each equivalent groups are contained by this problem
+    // @param feature_set: The indicator of candidate split features to evaluate
+    // @param id: Index of the local state entry used when a column buffer is needed
+    // @modifies negatives: summaries of the negative side of each candidate split, indexed by feature
+    // @modifies positives: summaries of the positive side of each candidate split, indexed by feature
+    // @note makes a single pass over the captured rows, accumulating counts for all active features
+    //       simultaneously from the row-major feature masks instead of rescanning per feature
+    void summarize_all(Bitmask const & capture_set, Bitmask const & feature_set,
+        std::vector< SplitSummary > & negatives, std::vector< SplitSummary > & positives, unsigned int id) const;
+
     // @param feature_index: the index of the binary feature to use bisect the set
     // @param positive: if true, modifies set to reflect the part of the bisection that responds positive to the binary feature
     //                  if false, the other part of the bisection is used
@@ -76,6 +108,15 @@ public:
     // Convenient alias for performing both negative and positive tests
     void subset(unsigned int feature_index, Bitmask & negative, Bitmask & positive) const;
 
+    // @param feature_index: the feature just split on, taken on its positive side
+    // @param feature_set: the candidate feature set of the positive subproblem
+    // @modifies feature_set: clears every member of feature_index's exclusive equality
+    //           block, all of which are constant on the positive side of the bisection
+    //           and can no longer split any descendant
+    // @note features outside any block (ordinal thresholds, lone equality tests) leave
+    //       feature_set untouched
+    void exclude_siblings(unsigned int feature_index, Bitmask & feature_set) const;
+
     // @param set: The indicator for each equivalent groups are contained by this problem
     // @param buffer: a buffer used for bitwise operations
     // @param i: feature index for pairwise comparison
@@ -83,9 +124,35 @@ public:
     // @return distance: The maximum change in objective value if feature i is swapped for j or vice versa
     float distance(Bitmask const & set, unsigned int i, unsigned int j, unsigned int id) const;
 
-    void tile(Bitmask const & filter, Bitmask const & selector, Tile & tile_output, std::vector< int > & order, unsigned int id) const;
+    // @param capture_set: The indicator for each equivalence classes contained by this problem
+    // @returns the total importance weight of the raw samples represented by the captured
+    //          equivalence classes; matches the raw sample count when no weights are configured
+    float weight(Bitmask const & capture_set) const;
+
+    // @returns the total importance weight of the full data set, used to normalize supports
+    //          and misprediction costs; matches size() when no weights are configured
+    float total_weight(void) const;
+
+    // @param filter: the captured equivalence classes of the subproblem to identify
+    // @param selector: the features still active in the subproblem
+    // @param tile_output: overwritten with the subproblem's identifying tile
+    // @param order: overwritten with the interned translation from canonical column positions
+    //               back to this subproblem's own feature and target indices
+    // @modifies tile_output: holds the captured submatrix with its feature columns sorted,
+    //           so subproblems identical up to feature order produce equal tiles and share
+    //           one vertex; when canonicalization is unsound or over budget the tile falls
+    //           back to the raw capture mask with the identity translation
+    void tile(Bitmask const & filter, Bitmask const & selector, Tile & tile_output, shared_translation & order, unsigned int id) const;
 
 private:
+    // @param D: compile-time class count, or 0 to read the count at runtime
+    // @note instantiated for the small class counts that dominate production fits, so the
+    //       compiler sees constant trip counts on the per-class inner loops and unrolls them;
+    //       summarize_all selects the matching instantiation and falls back to the generic one
+    template < unsigned int D >
+    void summarize_all_kernel(Bitmask const & capture_set, Bitmask const & feature_set,
+        std::vector< SplitSummary > & negatives, std::vector< SplitSummary > & positives, unsigned int id) const;
+
     static bool index_comparator(const std::pair< unsigned int, unsigned int > & left, const std::pair< unsigned int, unsigned int > & right);
 
     // The dimensions of the dataset
@@ -98,12 +165,33 @@ private:
     // std::vector< Bitmask > columns; // Binary representation of columns
     // std::vector< std::vector< float > > distributions; // Class distributions for each row
 
+    // All row-indexed structures below are in equivalence-class space: identical feature
+    // rows are collapsed at load into one class each, and the per-class sample counts in
+    // group_counts carry the lost multiplicities. Target masks indicate which labels are
+    // present in a class; the weighted counts come from the Index structures
     std::vector< Bitmask > features; // Binary representation of columns
     std::vector< Bitmask > targets; // Binary representation of columns
     std::vector< Bitmask > rows; // Binary representation of rows
     std::vector< Bitmask > feature_rows; // Binary representation of rows
     std::vector< Bitmask > target_rows; // Binary representation of rows
-    Bitmask majority; // Binary representation of columns
+
+    std::vector< unsigned int > group_counts; // Samples of each class in each equivalence class (row-major class-major)
+    std::vector< unsigned int > group_minimizers; // Cost-minimizing label of each equivalence class
+    std::vector< unsigned int > sample_groups; // Raw sample index to equivalence class index
+    std::vector< unsigned int > sample_labels; // Raw sample index to class label
+
+    // All loss arithmetic runs over importance weights rather than raw counts; without a
+    // configured weights file every sample weighs 1 and the weights reduce to the counts
+    std::vector< float > sample_weights; // Importance weight of each raw sample (empty when unweighted)
+    std::vector< float > group_weights; // Weight of each class in each equivalence class (row-major class-major)
+    std::vector< float > reference_weights; // Weight of samples the reference model labels correctly, per class per equivalence class
+    float _total_weight = 0.0; // Sum of all sample weights; matches the sample count when unweighted
+
+    Index target_weights; // Per-class sample weights of each equivalence class
+    // Fused per-class rows of [class weights | majority weights | reference match weights],
+    // so one prefix-sum pass over a capture mask yields every quantity a summary needs
+    Index summary_weights;
+    Index total_weights; // Total samples in each equivalence class
     std::vector< std::vector< float > > costs; // Cost matrix for each type of misprediction
     std::vector< float > match_costs; // Cost matrix for each type of misprediction
     std::vector< float > mismatch_costs; // Cost matrix for each type of misprediction
@@ -111,14 +199,82 @@ private:
     std::vector< float > min_costs; // Cost matrix for each type of misprediction
     std::vector< float > diff_costs; // Cost matrix for each type of misprediction
 
+    // One width-sized mask per exclusive equality block of the encoder; at most one member
+    // of a block responds positive for any sample, so splitting positively on one member
+    // leaves every other member constant false in the captured subproblem
+    std::vector< Bitmask > exclusion_blocks;
+    std::vector< int > feature_exclusions; // Per-feature index into exclusion_blocks, or -1 for features in no block
+
+    // Symmetric width x width matrix of feature distances over the full sample set, built
+    // once at load; since any capture set is a subset of the full set, each entry upper
+    // bounds the captured-set distance and remains a valid similar support bound
+    std::vector< float > distances;
+    float maximum_difference = 0.0; // Largest per-class cost difference, used to refine a precomputed distance per vertex
+
     // Index index; // Index for calculating summaries
-    // Index distance_index; // Index for calculating feature distances
+
+    // Memory mapping backing the shallow bitmasks when the dataset was loaded from cache
+    void * cache_mapping = NULL;
+    size_t cache_length = 0;
+
+    // Contiguous cache-aligned backing for the binarized matrices; when set, the bitmasks in
+    // rows, features, targets, feature_rows and target_rows are shallow views into this block
+    bitblock * matrix_storage = NULL;
+    size_t matrix_blocks = 0;
+
+    // @modifies repacks the binarized matrices into matrix_storage so the column-major and
+    //           row-major views each occupy one contiguous 64-byte-aligned region
+    void pack_bitmasks(void);
+
+    // @param path: location of the binary dataset cache
+    // @param content_hash: digest of the csv content used to validate the cache
+    // @returns true if the cache was valid and the dataset now points into the mapping zero-copy
+    bool load_cache(std::string const & path, unsigned long long content_hash);
+
+    // @param path: location to write the binary dataset cache
+    // @param content_hash: digest of the csv content stored for later validation
+    void save_cache(std::string const & path, unsigned long long content_hash) const;
+
+    // @modifies releases the active memory mapping, if any
+    // @note all shallow bitmasks into the mapping must be cleared before calling
+    void release_cache(void);
 
     void construct_bitmasks(std::istream & input_stream);
+    void construct_bitmasks(void);
     void construct_cost_matrix(void);
     void parse_cost_matrix(std::istream & input_stream);
     void aggregate_cost_matrix(void);
     void construct_majority(void);
+
+    // @modifies sample_weights: loads the per-sample importance weights when a weights file
+    //           is configured, leaving the vector empty otherwise
+    void construct_sample_weights(void);
+
+    // @modifies group_weights, target_weights, total_weights: folds the sample weights into
+    //           per-class weights and builds the Index structures that turn capture-set scans
+    //           into weighted class sums over the equivalence classes
+    void construct_group_weights(void);
+
+    // @modifies reference_weights: translates the reference model's per-sample labels into
+    //           per-class weights over the equivalence classes
+    // @note skipped unless Configuration::reference_LB() is set
+    void construct_reference_weights(void);
+
+    // @modifies exclusion_blocks, feature_exclusions: materializes the encoder's exclusive
+    //           equality blocks as feature masks, so sibling exclusion during exploration
+    //           is a single masked AND rather than a walk over the encoding rules
+    void construct_feature_groups(void);
+
+    // @modifies summary_weights: fuses the class, majority, and (under a reference model)
+    //           reference match weights of each equivalence class into one Index, so summaries
+    //           recover all of them with a single pass over the capture mask
+    void construct_summary_index(void);
+
+    // @modifies distances: fills the pairwise feature distance matrix, parallelized over
+    //           features and computing each unordered pair once
+    // @note skipped unless Configuration::similar_support() is set, since the matrix is
+    //       quadratic in the feature count
+    void construct_distance_index(void);
 };
 
 #endif
@@ -1,5 +1,8 @@
 #include "encoder.hpp"
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 Encoder::Encoder(void) {}
 
 // Construct an encoder which converts a non-binary data set into a binary-encoded dataset
@@ -13,6 +16,68 @@ Encoder::Encoder(std::istream & input) {
     // reindex(tokens); // Determine an efficient ordering of encoding rules
 
     encode(tokens, this -> binary_rows); // Encode the tokenized data using the encoding rules
+
+    // Optionally prune the ordinal thresholds down to the ones a boosted ensemble uses
+    if (Configuration::threshold_guessing()) { guess_thresholds(); }
+}
+
+// Construct an encoder for data that is already binarized
+// Feature columns encode one-to-one as equality tests against 1 and the label column
+// encodes as one equality test per distinct observed value, so no pass over the matrix
+// is needed beyond collecting the label values and setting the row bits
+Encoder::Encoder(unsigned char const * matrix, unsigned int samples, unsigned int columns) {
+    unsigned int const m = columns;
+    this -> number_of_rows = samples;
+    this -> number_of_columns = m;
+
+    this -> headers.resize(m);
+    for (unsigned int j = 0; j + 1 < m; ++j) { this -> headers[j] = "x" + std::to_string(j); }
+    this -> headers[m - 1] = "y";
+
+    this -> values.resize(m);
+    this -> cardinalities.resize(m, 2);
+    this -> optionalities.resize(m, false);
+    this -> inferred_types.resize(m, "Binary");
+    for (unsigned int j = 0; j + 1 < m; ++j) {
+        this -> values[j].insert("0");
+        this -> values[j].insert("1");
+    }
+
+    std::set< unsigned char > labels;
+    for (unsigned int i = 0; i < samples; ++i) { labels.insert(matrix[(size_t)(i) * m + (m - 1)]); }
+    for (auto iterator = labels.begin(); iterator != labels.end(); ++iterator) {
+        this -> values[m - 1].insert(std::to_string((unsigned int)(* iterator)));
+    }
+    this -> cardinalities[m - 1] = this -> values[m - 1].size();
+    this -> inferred_types[m - 1] = "Categorical";
+
+    for (unsigned int j = 0; j + 1 < m; ++j) {
+        std::vector< std::string > rule { "Binary", "==", "1" };
+        this -> codex.push_back(std::make_pair(j, rule));
+    }
+    for (auto iterator = this -> values[m - 1].begin(); iterator != this -> values[m - 1].end(); ++iterator) {
+        std::vector< std::string > rule { "Categorical", "==", * iterator };
+        this -> codex.push_back(std::make_pair(m - 1, rule));
+    }
+    this -> number_of_binary_targets = this -> values[m - 1].size();
+    this -> number_of_binary_columns = this -> codex.size();
+    group_exclusions(); // Every feature is its own equality test, so no blocks arise
+
+    unsigned int const o = this -> number_of_binary_columns;
+    unsigned int const p = this -> number_of_binary_targets;
+    std::vector< std::pair< unsigned int, std::vector< std::string > > > const & codex = this -> codex;
+    this -> binary_rows.resize(samples, o);
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, samples), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int i = range.begin(); i != range.end(); ++i) {
+            unsigned char const * row = matrix + (size_t)(i) * m;
+            Bitmask & binary_row = this -> binary_rows[i];
+            for (unsigned int j = 0; j + 1 < m; ++j) { binary_row.set(j, row[j] != 0); }
+            std::string const label = std::to_string((unsigned int)(row[m - 1]));
+            for (unsigned int l = 0; l < p; ++l) {
+                binary_row.set(o - p + l, codex[o - p + l].second[2] == label);
+            }
+        }
+    });
 }
 
 // Tests whether a string should be considered an integer
@@ -67,7 +132,7 @@ float Encoder::limit_precision(float number) const {
     if (number == 0.0) { return number; }
     float sign = number >= 0.0 ? 1.0 : -1.0;
     float magnitude = abs(number);
-    unsigned int precision = Configuration::precision_limit;
+    unsigned int precision = Configuration::precision_limit();
     float max = pow(10.0, precision); 
     float min = pow(10.0, precision - 1);
     int k = 0;
@@ -93,25 +158,35 @@ float Encoder::limit_precision(float number) const {
 
 void Encoder::tokenize(std::istream & input_stream, std::vector< std::vector< std::string > > & rows) {
     io::LineReader input("", input_stream);
-    unsigned int line_index = 0;
-	while (char * line = input.next_line()) {
-        std::stringstream stream(line);
-        std::string token;
-        std::vector< std::string > row;
-        while (stream.good()) {
-            getline(stream, token, ',');
-            row.push_back(token);
+    std::vector< std::string > lines;
+    while (char * line = input.next_line()) { lines.emplace_back(line); }
+
+    // Line splitting carries no cross-line state, so lines are tokenized in parallel chunks
+    std::vector< std::vector< std::string > > parsed(lines.size());
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, lines.size()), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int i = range.begin(); i != range.end(); ++i) {
+            std::stringstream stream(lines[i]);
+            std::string token;
+            while (stream.good()) {
+                getline(stream, token, ',');
+                parsed[i].push_back(token);
+            }
         }
-        if (row.empty()) { continue; }
-		if (line_index == 0) {
-            this -> headers = row;
-            this -> number_of_columns = row.size();
-		} else {
-			rows.push_back(row);
+    });
+
+    // The first non-empty line is the header, the remaining non-empty lines are samples
+    bool header_seen = false;
+    for (unsigned int i = 0; i < parsed.size(); ++i) {
+        if (parsed[i].empty()) { continue; }
+        if (!header_seen) {
+            this -> headers = parsed[i];
+            this -> number_of_columns = parsed[i].size();
+            header_seen = true;
+        } else {
+            rows.emplace_back(std::move(parsed[i]));
             this -> number_of_rows += 1;
-		}
-        ++line_index;
-	}
+        }
+    }
 }
 
 void Encoder::parse(std::vector< std::vector< std::string > > const & rows) {
@@ -127,34 +202,35 @@ void Encoder::parse(std::vector< std::vector< std::string > > const & rows) {
     std::vector< std::string > & inferred_types = this -> inferred_types;
     inferred_types.resize(m, "Undefined");
 
-    std::map< std::string, unsigned int > target_distribution;
-
     // Content-based type inference
-    for (unsigned int i = 0; i < n; ++i) {
-        for (unsigned int j = 0; j < m; ++j) {
-            std::string const & element = rows[i][j];
+    // Each column's value set, optionality and type depend only on that column, so
+    // columns are inferred in parallel with rows visited in order within each column
+    // vector< bool > packs bits, so optionality is accumulated in plain bytes first
+    std::vector< char > optional_columns(m, 0);
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, m), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int j = range.begin(); j != range.end(); ++j) {
             std::string & inferred_type = inferred_types[j];
-            if (element == "" || element == "NULL" || element == "null" || element == "Null" || element == "NA" || element == "na" || element == "NaN") {
-                optionalities[j] = true;
-                continue;
-            }
-            if ((inferred_type == "Undefined" || inferred_type == "Integral") && Encoder::test_integral(element)) {
-                inferred_type = "Integral";
-            } else if ((inferred_type == "Undefined" || inferred_type == "Integral" || inferred_type == "Rational") && Encoder::test_rational(element)) {
-                inferred_type = "Rational";
-            } else {
-                inferred_type = "Categorical";
-            }
-            values[j].insert(element);
-
-            if (j == m - 1) {
-                target_distribution[element] += 1;
+            for (unsigned int i = 0; i < n; ++i) {
+                std::string const & element = rows[i][j];
+                if (element == "" || element == "NULL" || element == "null" || element == "Null" || element == "NA" || element == "na" || element == "NaN") {
+                    optional_columns[j] = 1;
+                    continue;
+                }
+                if ((inferred_type == "Undefined" || inferred_type == "Integral") && Encoder::test_integral(element)) {
+                    inferred_type = "Integral";
+                } else if ((inferred_type == "Undefined" || inferred_type == "Integral" || inferred_type == "Rational") && Encoder::test_rational(element)) {
+                    inferred_type = "Rational";
+                } else {
+                    inferred_type = "Categorical";
+                }
+                values[j].insert(element);
             }
         }
-    }
+    });
+    for (unsigned int j = 0; j < m; ++j) { optionalities[j] = bool(optional_columns[j]); }
 
     // Special processing of numerical data, the user can choose to limit the numerical precision
-    if (Configuration::precision_limit > 0) { limit_precision(values); }
+    if (Configuration::precision_limit() > 0) { limit_precision(values); }
 
     // Further type specification based on column statistics
     for (unsigned int j = 0; j < m; ++j) {
@@ -285,9 +361,10 @@ void Encoder::build(void) {
 
     unsigned int number_of_binary_columns = codex.size();
     this -> number_of_binary_columns = number_of_binary_columns;
+    group_exclusions();
 
     // Display the result of type inference and codex building
-    if (Configuration::verbose) {
+    if (Configuration::verbose()) {
         for (unsigned int j = 0; j < m; ++j) {
             std::cout << "Feature Index: " << j << ", Feature Name: " << this -> headers[j] << std::endl;
             std::cout << "  Inferred Type: " << inferred_types[j];
@@ -299,6 +376,135 @@ void Encoder::build(void) {
     }
 }
 
+// Equality encodings of one source column are emitted contiguously and any sample
+// satisfies at most one of them (none, when the sample's value is null), so each run of
+// two or more forms an exclusive block; runs of one carry no siblings and are skipped
+void Encoder::group_exclusions(void) {
+    unsigned int const width = this -> number_of_binary_columns - this -> number_of_binary_targets;
+    this -> exclusions.clear();
+    for (unsigned int start = 0; start < width;) {
+        if (this -> codex[start].second[1] != "==") { start += 1; continue; }
+        unsigned int finish = start;
+        while (finish < width
+            && this -> codex[finish].second[1] == "=="
+            && this -> codex[finish].first == this -> codex[start].first) { finish += 1; }
+        if (finish - start >= 2) { this -> exclusions.emplace_back(start, finish); }
+        start = finish;
+    }
+}
+
+void Encoder::guess_thresholds(void) {
+    unsigned int const n = this -> number_of_rows;
+    unsigned int const o = this -> number_of_binary_columns;
+    unsigned int const p = this -> number_of_binary_targets;
+    unsigned int const candidates = o - p;
+    if (n == 0 || candidates == 0 || p < 2) { return; }
+
+    bool ordinal = false;
+    for (unsigned int k = 0; k < candidates; ++k) { ordinal = ordinal || this -> codex[k].second[1] == ">="; }
+    if (!ordinal) { return; } // Only threshold features are subject to pruning
+
+    // The class index of each sample, recovered from the one-hot target bits
+    std::vector< unsigned int > labels(n, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int l = 0; l < p; ++l) {
+            if (bool(this -> binary_rows[i][candidates + l])) { labels[i] = l; }
+        }
+    }
+
+    // Boosted decision stumps over the candidate binary features (SAMME weighting so
+    // multiclass targets work); each round marks the threshold its stump tests as used
+    std::vector< double > weights(n, 1.0 / n);
+    std::vector< char > used(candidates, 0);
+    unsigned int const rounds = Configuration::threshold_guessing_rounds();
+    for (unsigned int round = 0; round < rounds; ++round) {
+        int best_feature = -1;
+        double best_error = std::numeric_limits<double>::max();
+        unsigned int best_majority[2] = { 0, 0 };
+        std::vector< double > side_class(2 * p);
+        for (unsigned int k = 0; k < candidates; ++k) {
+            std::fill(side_class.begin(), side_class.end(), 0.0);
+            for (unsigned int i = 0; i < n; ++i) {
+                side_class[bool(this -> binary_rows[i][k]) * p + labels[i]] += weights[i];
+            }
+            double error = 1.0;
+            unsigned int majority[2] = { 0, 0 };
+            for (unsigned int side = 0; side < 2; ++side) {
+                double maximum = 0.0;
+                for (unsigned int c = 0; c < p; ++c) {
+                    if (side_class[side * p + c] > maximum) {
+                        maximum = side_class[side * p + c];
+                        majority[side] = c;
+                    }
+                }
+                error -= maximum;
+            }
+            if (error < best_error) {
+                best_error = error;
+                best_feature = k;
+                best_majority[0] = majority[0];
+                best_majority[1] = majority[1];
+            }
+        }
+        if (best_feature < 0 || best_error >= 1.0 - 1.0 / p) { break; } // No stump beats chance
+        used[best_feature] = 1;
+        if (best_error <= 0.0) { break; } // Perfect stump; further rounds would repeat it
+        double const alpha = std::log((1.0 - best_error) / best_error) + std::log((double)(p - 1));
+        double total = 0.0;
+        for (unsigned int i = 0; i < n; ++i) {
+            unsigned int prediction = best_majority[bool(this -> binary_rows[i][best_feature])];
+            if (prediction != labels[i]) { weights[i] *= std::exp(alpha); }
+            total += weights[i];
+        }
+        for (unsigned int i = 0; i < n; ++i) { weights[i] /= total; }
+    }
+
+    // Keep equality features as-is, threshold features only if the ensemble used them,
+    // and all target bits; a column whose thresholds all go unused drops entirely
+    std::vector< unsigned int > kept;
+    for (unsigned int k = 0; k < candidates; ++k) {
+        if (this -> codex[k].second[1] != ">=" || used[k]) { kept.push_back(k); }
+    }
+    if (kept.size() == candidates) { return; } // Nothing to prune
+    unsigned int const width = kept.size();
+    for (unsigned int l = 0; l < p; ++l) { kept.push_back(candidates + l); }
+
+    std::vector< std::pair< unsigned int, std::vector< std::string > > > pruned_codex;
+    for (auto iterator = kept.begin(); iterator != kept.end(); ++iterator) {
+        pruned_codex.push_back(this -> codex[* iterator]);
+    }
+    this -> codex = pruned_codex;
+
+    // Boundaries regroup the surviving thresholds by their source column
+    this -> boundaries.clear();
+    for (unsigned int start = 0; start < width;) {
+        if (this -> codex[start].second[1] != ">=") { start += 1; continue; }
+        unsigned int finish = start;
+        while (finish < width
+            && this -> codex[finish].second[1] == ">="
+            && this -> codex[finish].first == this -> codex[start].first) { finish += 1; }
+        this -> boundaries.emplace_back(start, finish);
+        start = finish;
+    }
+    group_exclusions(); // Equality blocks shift with the dropped thresholds
+
+    std::vector< Bitmask > compacted;
+    compacted.resize(n, kept.size());
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, n), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int i = range.begin(); i != range.end(); ++i) {
+            for (unsigned int j = 0; j < kept.size(); ++j) {
+                compacted[i].set(j, bool(this -> binary_rows[i][kept[j]]));
+            }
+        }
+    });
+    this -> binary_rows = std::move(compacted);
+    this -> number_of_binary_columns = kept.size();
+
+    if (Configuration::verbose()) {
+        std::cout << "Threshold Guessing Reduced Binary Features: " << candidates << " -> " << width << std::endl;
+    }
+}
+
 void Encoder::reindex(std::vector< std::vector< std::string > > const & rows) {
     const unsigned int m = this -> number_of_columns;
     const unsigned int n = this -> number_of_rows;
@@ -389,26 +595,28 @@ void Encoder::encode(std::vector< std::vector< std::string > > const & rows, std
     const unsigned int n = this -> number_of_rows;
     const unsigned int o = this -> number_of_binary_columns;
     std::vector< std::pair< unsigned int, std::vector< std::string > > > const & codex = this -> codex;
-    for (unsigned int i = 0; i < n; ++i) {
-        Bitmask binary_row(o);
-        for (unsigned int k = 0; k < o; ++k) {
-            std::pair< unsigned int, std::vector< std::string > > rule = codex.at(k);
-            unsigned int j = rule.first;
-            std::string inferred_type = rule.second[0];
-            std::string relation = rule.second[1];
-            std::string reference = rule.second[2];
-            bool value;
-            if (inferred_type == "Integral") {
-                value = (atoi(rows[i][j].c_str()) >= atoi(reference.c_str()));
-            } else if (inferred_type == "Rational") {
-                value = (atof(rows[i][j].c_str()) >= atof(reference.c_str()));
-            } else {
-                value = (rows[i][j] == reference);
+    // Rows encode independently of each other, so each task encodes a chunk of rows
+    binary_rows.resize(n, o);
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, n), [&](tbb::blocked_range< unsigned int > const & range) {
+        for (unsigned int i = range.begin(); i != range.end(); ++i) {
+            Bitmask & binary_row = binary_rows[i];
+            for (unsigned int k = 0; k < o; ++k) {
+                std::pair< unsigned int, std::vector< std::string > > const & rule = codex.at(k);
+                unsigned int j = rule.first;
+                std::string const & inferred_type = rule.second[0];
+                std::string const & reference = rule.second[2];
+                bool value;
+                if (inferred_type == "Integral") {
+                    value = (atoi(rows[i][j].c_str()) >= atoi(reference.c_str()));
+                } else if (inferred_type == "Rational") {
+                    value = (atof(rows[i][j].c_str()) >= atof(reference.c_str()));
+                } else {
+                    value = (rows[i][j] == reference);
+                }
+                binary_row.set(k, value);
             }
-            binary_row.set(k, value);
         }
-        binary_rows.emplace_back(binary_row);
-    }
+    });
     return;
 }
 
@@ -495,4 +703,68 @@ unsigned int Encoder::binary_features(void) const {
 
 unsigned int Encoder::binary_targets(void) const {
     return this -> number_of_binary_targets;
-}
\ No newline at end of file
+}
+void Encoder::summarize(nlohmann::json & schema) const {
+    schema["headers"] = this -> headers;
+    schema["number_of_rows"] = this -> number_of_rows;
+    schema["number_of_columns"] = this -> number_of_columns;
+    schema["number_of_binary_columns"] = this -> number_of_binary_columns;
+    schema["number_of_binary_targets"] = this -> number_of_binary_targets;
+    schema["weights"] = this -> weights;
+    schema["cardinalities"] = this -> cardinalities;
+    schema["optionalities"] = this -> optionalities;
+    schema["inferred_types"] = this -> inferred_types;
+
+    nlohmann::json values = nlohmann::json::array();
+    for (unsigned int j = 0; j < this -> values.size(); ++j) {
+        values.emplace_back(std::vector< std::string >(this -> values[j].begin(), this -> values[j].end()));
+    }
+    schema["values"] = values;
+
+    nlohmann::json codex = nlohmann::json::array();
+    for (unsigned int j = 0; j < this -> codex.size(); ++j) {
+        nlohmann::json entry = nlohmann::json::object();
+        entry["source"] = this -> codex[j].first;
+        entry["rule"] = this -> codex[j].second;
+        codex.emplace_back(entry);
+    }
+    schema["codex"] = codex;
+
+    nlohmann::json boundaries = nlohmann::json::array();
+    for (unsigned int j = 0; j < this -> boundaries.size(); ++j) {
+        boundaries.emplace_back(std::vector< unsigned int >{ this -> boundaries[j].first, this -> boundaries[j].second });
+    }
+    schema["boundaries"] = boundaries;
+}
+
+void Encoder::restore(nlohmann::json const & schema) {
+    this -> headers = schema["headers"].get< std::vector< std::string > >();
+    this -> number_of_rows = schema["number_of_rows"];
+    this -> number_of_columns = schema["number_of_columns"];
+    this -> number_of_binary_columns = schema["number_of_binary_columns"];
+    this -> number_of_binary_targets = schema["number_of_binary_targets"];
+    this -> weights = schema["weights"].get< std::vector< float > >();
+    this -> cardinalities = schema["cardinalities"].get< std::vector< unsigned int > >();
+    this -> optionalities = schema["optionalities"].get< std::vector< bool > >();
+    this -> inferred_types = schema["inferred_types"].get< std::vector< std::string > >();
+
+    this -> values.clear();
+    for (auto iterator = schema["values"].begin(); iterator != schema["values"].end(); ++iterator) {
+        std::vector< std::string > values = iterator -> get< std::vector< std::string > >();
+        this -> values.emplace_back(values.begin(), values.end());
+    }
+
+    this -> codex.clear();
+    for (auto iterator = schema["codex"].begin(); iterator != schema["codex"].end(); ++iterator) {
+        this -> codex.emplace_back((* iterator)["source"].get< unsigned int >(), (* iterator)["rule"].get< std::vector< std::string > >());
+    }
+
+    this -> boundaries.clear();
+    for (auto iterator = schema["boundaries"].begin(); iterator != schema["boundaries"].end(); ++iterator) {
+        std::vector< unsigned int > boundary = iterator -> get< std::vector< unsigned int > >();
+        this -> boundaries.emplace_back(boundary[0], boundary[1]);
+    }
+    group_exclusions(); // Rederived from the restored codex rather than serialized
+
+    this -> binary_rows.clear(); // Binary rows are restored separately from the binary payload of the cache
+}
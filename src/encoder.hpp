@@ -10,6 +10,7 @@
 #include <set>
 #include <unordered_set>
 #include <csv/csv.h>
+#include <json/json.hpp>
 
 #include "bitmask.hpp"
 #include "configuration.hpp"
@@ -44,6 +45,15 @@ public:
     // @param input: Input stream of bytes containing contents of a CSV
     Encoder(std::istream & input);
 
+    // Construct an encoder for data that is already binarized, skipping tokenization,
+    // type inference and re-encoding entirely
+    // @param matrix: row-major samples x columns matrix of bytes where the first
+    //   columns - 1 entries of each row are 0/1 feature indicators and the last entry
+    //   is the class label
+    // @note every feature column maps to exactly one binary feature (== 1), including
+    //   constant columns, so binary feature indices line up with the matrix columns
+    Encoder(unsigned char const * matrix, unsigned int samples, unsigned int columns);
+
     // @param string: a string that may contain a number
     // @return whether string qualifies as a string representation of an integer (Using pattern: ^[+-]?\d+$)
     static bool test_integral(std::string const & string);
@@ -112,9 +122,22 @@ public:
     // @returns the importance given to the queried sample
     // float weight(unsigned int index) const;
 
+    // @param schema: json object to contain the encoding schema
+    // @modifies schema: initialized with all state needed to restore this encoder without reparsing the csv
+    // @note the binary rows themselves are excluded; they are cached separately in binary form
+    void summarize(nlohmann::json & schema) const;
+
+    // @param schema: json object previously produced by summarize
+    // @modifies restores the encoder state described by schema
+    void restore(nlohmann::json const & schema);
+
     // The boundary indices for binary features that belong to the same ordinal feature.
     std::vector< std::pair< unsigned int, unsigned int > > boundaries;
 
+    // Half-open ranges of binary features that form an exclusive equality block: the
+    // equality encodings of one source column, of which any sample satisfies at most one
+    std::vector< std::pair< unsigned int, unsigned int > > exclusions;
+
 private:
     // Original data
     std::vector< std::string > headers;
@@ -146,6 +169,13 @@ private:
     int limit_precision(int number) const;
     float limit_precision(float number) const;
 
+    // @modifies prunes the codex, boundaries and binary rows down to the threshold
+    //   features used by a boosted stump ensemble trained on the encoded data, keeping
+    //   equality-encoded features and targets untouched
+    // @note runs for Configuration::threshold_guessing_rounds() boosting rounds; columns
+    //   whose thresholds are never chosen by a stump are dropped entirely
+    void guess_thresholds(void);
+
     // @param input: an input stream containing a CSV
     // @modifies tokens: stores the tokens of input in tokens in row-major order
     // @modifies this -> header: stores the csv header 
@@ -166,6 +196,10 @@ private:
     // @modifies this -> codex: initializes a vector of vectors (see definition for codex structure)
     void build(void);
 
+    // @modifies this -> exclusions: rederives the exclusive equality blocks from the codex,
+    //   so the ranges stay aligned after any pruning or restoration of the encoding rules
+    void group_exclusions(void);
+
     // @param rows: csv of tokens
     // @param binary_rows: vector of bitmasks representing a binary data set in row-major order
     // @modifies binary_rows: initialized with the binary representation of rows
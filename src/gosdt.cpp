@@ -1,215 +1,488 @@
-#include "gosdt.hpp"
-
-//#include <sys/time.h>
-//#include <sys/resource.h>  // FIREWOLF: Incompatible with Windows
-
-#define _DEBUG true
-#define THROTTLE false
-
-float GOSDT::time = 0.0;
-unsigned int GOSDT::size = 0;
-unsigned int GOSDT::iterations = 0;
-unsigned int GOSDT::status = 0;
-
-double GOSDT::lower_bound;
-double GOSDT::upper_bound;
-float GOSDT::model_loss;
-
-float  GOSDT::ru_utime;
-float  GOSDT::ru_stime;
-long   GOSDT::ru_maxrss;
-long   GOSDT::ru_nswap;
-long   GOSDT::ru_nivcsw;
-
-GOSDT::GOSDT(void) {}
-
-GOSDT::~GOSDT(void) {
-    return;
-}
-
-void GOSDT::configure(std::istream & config_source) { Configuration::configure(config_source); }
-
-void GOSDT::fit(std::istream & data_source, std::string & result) {
-    std::unordered_set< Model > models;
-    fit(data_source, models);
-    json output = json::array();
-    for (auto iterator = models.begin(); iterator != models.end(); ++iterator) {
-        Model model = * iterator;
-        json object = json::object();
-        model.to_json(object);
-        output.push_back(object);
-    }
-    result = output.dump(2);
-}
-
-void GOSDT::fit(std::istream & data_source, std::unordered_set< Model > & models) {
-    if(Configuration::verbose) { std::cout << "Using configuration: " << Configuration::to_string(2) << std::endl; }
-
-    if(Configuration::verbose) { std::cout << "Initializing Optimization Framework" << std::endl; }
-    Optimizer optimizer;
-    optimizer.load(data_source);
-
-    int const n = State::dataset.size();
-    if(Configuration::regularization < (float) 1/n) {
-        std::cout << "Regularization smaller than 1/(num_samples) - this may lead to longer training time if not adjusted." << std::endl;
-        if (!Configuration::allow_small_reg) {
-            std::cout << "Regularization increased to 1/(num_samples) = " << (1/n) << ". To allow regularization below this, set allow_small_reg to true" << std::endl;
-            Configuration::regularization = (float) 1/n;
-        }
-    }
-
-    GOSDT::time = 0.0;
-    GOSDT::size = 0;
-    GOSDT::iterations = 0;
-    GOSDT::status = 0;
-
-    std::vector< std::thread > workers;
-    std::vector< int > iterations(Configuration::worker_limit);
-
-    if(Configuration::verbose) { std::cout << "Starting Optimization" << std::endl; }
-
-//    static struct rusage usage_start, usage_end;
-//    if (getrusage(RUSAGE_SELF, &usage_start)) {
-//         std::cout << "WARNING: rusage returned non-zero value" << std::endl;
-//    }
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    optimizer.initialize();
-    if (Configuration::worker_limit > 1) {
-        for (unsigned int i = 0; i < Configuration::worker_limit; ++i) {
-            workers.emplace_back(work, i, std::ref(optimizer), std::ref(iterations[i]));
-//            #ifndef __APPLE__
-//            // If using Ubuntu Build, we can pin each thread to a specific CPU core to improve cache locality
-//            cpu_set_t cpuset; CPU_ZERO(&cpuset); CPU_SET(i, &cpuset);
-//            int error = pthread_setaffinity_np(workers[i].native_handle(), sizeof(cpu_set_t), &cpuset);
-//            if (error != 0) { std::cerr << "Error calling pthread_setaffinity_np: " << error << std::endl; }
-//            #endif
-        }
-        for (auto iterator = workers.begin(); iterator != workers.end(); ++iterator) { (* iterator).join(); } // Wait for the thread pool to terminate
-    }else { 
-        work(0, optimizer, iterations[0]);
-    }
-
-    auto stop = std::chrono::high_resolution_clock::now(); // Stop measuring training time
-// FIREWOLF: Incompatible with Windows MSVC
-//    if (getrusage(RUSAGE_SELF, &usage_end)) {
-//        std::cout << "WARNING: rusage returned non-zero value" << std::endl;
-//        GOSDT::ru_utime = -1;
-//        GOSDT::ru_stime = -1;
-//        GOSDT::ru_maxrss = -1;
-//        GOSDT::ru_nswap = -1;
-//        GOSDT::ru_nivcsw = -1;
-//    } else {
-//        struct timeval delta;
-//        timersub(&usage_end.ru_utime, &usage_start.ru_utime, &delta);
-//        GOSDT::ru_utime = (float)delta.tv_sec + (((float)delta.tv_usec) / 1000000);
-//        timersub(&usage_end.ru_stime, &usage_start.ru_stime, &delta);
-//        GOSDT::ru_stime = (float)delta.tv_sec + (((float)delta.tv_usec) / 1000000);
-//        GOSDT::ru_maxrss = usage_end.ru_maxrss;
-//        GOSDT::ru_nswap = usage_end.ru_nswap - usage_start.ru_nswap;
-//        GOSDT::ru_nivcsw = usage_end.ru_nivcsw - usage_start.ru_nivcsw;
-//    }
-    GOSDT::time = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() / 1000.0;
-    if(Configuration::verbose) { std::cout << "Optimization Complete" << std::endl; }
-
-    for (auto iterator = iterations.begin(); iterator != iterations.end(); ++iterator) { GOSDT::iterations += * iterator; }
-    GOSDT::size = optimizer.size();
-    float lowerbound, upperbound;
-    optimizer.objective_boundary(& lowerbound, & upperbound);
-    GOSDT::lower_bound = lowerbound;
-    GOSDT::upper_bound = upperbound;
-
-    if(Configuration::verbose) { std::cout << "Optimization Complete" << std::endl; }
-
-
-    if (Configuration::timing != "") {
-        std::ofstream timing_output(Configuration::timing, std::ios_base::app);
-        timing_output << GOSDT::time;
-        timing_output.flush();
-        timing_output.close();
-    }
-
-    if(Configuration::verbose) {
-        std::cout << "Training Duration: " << GOSDT::time << " seconds" << std::endl;
-        std::cout << "Number of Iterations: " << GOSDT::iterations << " iterations" << std::endl;
-        std::cout << "Size of Graph: " << GOSDT::size << " nodes" << std::endl;
-        std::cout << "Training Duration (user time): " <<  GOSDT::ru_utime << " seconds" << std::endl;
-        std::cout << "Training Duration (system time)" << GOSDT::ru_stime << " seconds" << std::endl;
-        std::cout << "Maximim memory: " << GOSDT::ru_utime  << " kB" << std::endl;
-        std::cout << "Number of swaps" << GOSDT::ru_nswap << std::endl;
-        std::cout << "Size of Search Graph: " << optimizer.size() << " nodes" << std::endl;
-        std::cout << "Objective Boundary: [" << lowerbound << ", " << upperbound << "]" << std::endl;
-        std::cout << "Optimality Gap: " << optimizer.uncertainty() << std::endl;
-    }
-
-    try {
-        if (!optimizer.complete()) {
-            // there might be a timeout here...
-            if (GOSDT::time > (float)Configuration::time_limit || !State::queue.empty()) {
-                std::cout << "possible timeout: " << GOSDT::time << " " << Configuration::time_limit << " queue emtpy: "  << State::queue.empty() << std::endl;
-                GOSDT::status = 2;
-            } else {
-                std::cout << "possible non-convergence: [" << lowerbound << " .. " << upperbound << "]" << std::endl;
-                GOSDT::status = 1;
-            }
-
-            if (Configuration::diagnostics) {
-                std::cout << "Non-convergence Detected. Beginning Diagnosis" << std::endl;
-                optimizer.diagnose_non_convergence();
-                std::cout << "Diagnosis complete" << std::endl;
-            }
-        }
-
-        optimizer.models(models);
-
-        if (Configuration::model_limit > 0 && models.size() == 0) {
-            GOSDT::status = 1;
-            if (Configuration::diagnostics) {
-                std::cout << "False-convergence Detected. Beginning Diagnosis" << std::endl;
-                optimizer.diagnose_false_convergence();
-                std::cout << "Diagnosis complete" << std::endl;
-            }
-            throw IntegrityViolation("No model","No model found - either user-provided upper bound assumption was too strong, or there was a false convergence");
-        }
-
-        if (Configuration::verbose) {
-            std::cout << "Models Generated: " << models.size() << std::endl;
-            if (optimizer.uncertainty() == 0.0 && models.size() > 0) {
-                std::cout << "Loss: " << models.begin() -> loss() << std::endl;
-                std::cout << "Complexity: " << models.begin() -> complexity() << std::endl;
-            }
-        }
-        GOSDT::model_loss = models.begin() -> loss();
-        if (Configuration::model != "") {
-            json output = json::array();
-            for (auto iterator = models.begin(); iterator != models.end(); ++iterator) {
-                Model model = * iterator;
-                json object = json::object();
-                model.to_json(object);
-                output.push_back(object);
-            }
-            std::string result = output.dump(2);
-            if(Configuration::verbose) { std::cout << "Storing Models in: " << Configuration::model << std::endl; }
-            std::ofstream out(Configuration::model);
-            out << result;
-            out.close();
-        }
-    } catch (IntegrityViolation exception) {
-        GOSDT::status = 1;
-        std::cout << exception.to_string() << std::endl;
-    }
-}
-
-
-void GOSDT::work(int const id, Optimizer & optimizer, int & return_reference) {
-    unsigned int iterations = 0;
-    try {
-        while (optimizer.iterate(id)) { iterations += 1; }
-    } catch( IntegrityViolation exception ) {
-        GOSDT::status = 1;
-        std::cout << exception.to_string() << std::endl;
-        throw std::move(exception);
-    }
-    return_reference = iterations;
-}
+#include "gosdt.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//#include <sys/time.h>
+//#include <sys/resource.h>  // FIREWOLF: Incompatible with Windows
+
+#define _DEBUG true
+#define THROTTLE false
+
+thread_local float GOSDT::time = 0.0;
+thread_local unsigned int GOSDT::size = 0;
+thread_local unsigned int GOSDT::iterations = 0;
+thread_local unsigned int GOSDT::status = 0;
+
+thread_local double GOSDT::lower_bound;
+thread_local double GOSDT::upper_bound;
+thread_local float GOSDT::model_loss;
+
+thread_local float  GOSDT::ru_utime;
+thread_local float  GOSDT::ru_stime;
+thread_local long   GOSDT::ru_maxrss;
+thread_local long   GOSDT::ru_nswap;
+thread_local long   GOSDT::ru_nivcsw;
+
+GOSDT::GOSDT(void) {}
+
+GOSDT::~GOSDT(void) {
+    // Unbind the calling thread if it is still bound to this instance's state
+    if (& State::active() == & this -> context) { State::bind(NULL); }
+    if (& Configuration::active() == & this -> settings) { Configuration::bind(NULL); }
+    return;
+}
+
+void GOSDT::configure(std::istream & config_source) { Configuration::configure(config_source); }
+
+void GOSDT::retain(bool keep) { this -> retained = keep; }
+
+void GOSDT::fit(std::istream & data_source, std::string & result) {
+    bind();
+    if(Configuration::verbose()) { std::cout << "Initializing Optimization Framework" << std::endl; }
+    Optimizer optimizer;
+    optimizer.retain_dataset = this -> retained;
+    optimizer.load(data_source);
+    serialize(optimizer, result);
+}
+
+void GOSDT::fit(unsigned char const * matrix, unsigned int samples, unsigned int columns, std::string & result) {
+    bind();
+    if(Configuration::verbose()) { std::cout << "Initializing Optimization Framework" << std::endl; }
+    Optimizer optimizer;
+    optimizer.retain_dataset = this -> retained;
+    optimizer.load(matrix, samples, columns);
+    serialize(optimizer, result);
+}
+
+void GOSDT::fit(std::string & result) {
+    bind();
+    if(Configuration::verbose()) { std::cout << "Reusing Loaded Dataset" << std::endl; }
+    Optimizer optimizer;
+    optimizer.retain_dataset = this -> retained;
+    optimizer.load();
+    serialize(optimizer, result);
+}
+
+void GOSDT::serialize(Optimizer & optimizer, std::string & result) {
+    // Append each model's JSON as it is emitted, reproducing the layout of dumping the full
+    // array at indent 2 without ever holding more than one extracted model in memory
+    result = "[";
+    bool first = true;
+    std::string binary_buffer;
+    unsigned int binary_count = 0;
+    std::unordered_set< Model > models; // Stays empty; extraction goes through the callback
+    solve(optimizer, models, [&](Model & model) {
+        if (Configuration::binary_model() != "") {
+            model.to_binary(binary_buffer);
+            binary_count += 1;
+        }
+        json object = json::object();
+        model.to_json(object);
+        std::string element = object.dump(2);
+        size_t position = 0;
+        while ((position = element.find('\n', position)) != std::string::npos) {
+            element.insert(position + 1, "  ");
+            position += 3;
+        }
+        result += first ? "\n  " : ",\n  ";
+        result += element;
+        first = false;
+    });
+    result += first ? "]" : "\n]";
+
+    // The streamed path bypasses the set-based model file write in solve
+    if (Configuration::model() != "" && !first) {
+        if(Configuration::verbose()) { std::cout << "Storing Models in: " << Configuration::model() << std::endl; }
+        Writer::write(Configuration::model(), std::string(result));
+        // The caller may read the model file back as soon as fit returns
+        Writer::flush();
+    }
+    if (Configuration::binary_model() != "" && binary_count > 0) {
+        if(Configuration::verbose()) { std::cout << "Storing Binary Models in: " << Configuration::binary_model() << std::endl; }
+        Model::save_binary(Configuration::binary_model(), binary_buffer, binary_count);
+    }
+}
+
+void GOSDT::fit(std::istream & data_source, std::unordered_set< Model > & models) {
+    bind();
+    if(Configuration::verbose()) { std::cout << "Initializing Optimization Framework" << std::endl; }
+    Optimizer optimizer;
+    optimizer.retain_dataset = this -> retained;
+    optimizer.load(data_source);
+    solve(optimizer, models);
+}
+
+void GOSDT::fit(unsigned char const * matrix, unsigned int samples, unsigned int columns, std::unordered_set< Model > & models) {
+    bind();
+    if(Configuration::verbose()) { std::cout << "Initializing Optimization Framework" << std::endl; }
+    Optimizer optimizer;
+    optimizer.retain_dataset = this -> retained;
+    optimizer.load(matrix, samples, columns);
+    solve(optimizer, models);
+}
+
+void GOSDT::bind(void) {
+    // Adopt the configuration staged on the calling thread, then bind this instance's context
+    // and configuration so concurrent fits in one process do not share mutable state
+    this -> settings = Configuration::active();
+    Configuration::bind(& this -> settings);
+    State::bind(& this -> context);
+
+    if(Configuration::verbose()) { std::cout << "Using configuration: " << Configuration::to_string(2) << std::endl; }
+}
+
+void GOSDT::autotune(Optimizer & optimizer) {
+    // Combinations of the bound flags that each win on some dataset families; the configured
+    // combination leads the portfolio, so ties resolve in its favour
+    struct Candidate { bool look_ahead; bool similar_support; bool feature_exchange; bool continuous_feature_exchange; bool cancellation; };
+    std::vector< Candidate > portfolio;
+    Candidate const configured = {
+        Configuration::look_ahead(), Configuration::similar_support(), Configuration::feature_exchange(),
+        Configuration::continuous_feature_exchange(), Configuration::cancellation()
+    };
+    portfolio.push_back(configured);
+    portfolio.push_back({ false, true, false, false, true }); // Look-ahead prunes aggressively but can starve the frontier
+    portfolio.push_back({ true, false, false, false, true }); // The similar-support index costs a scan per visit
+    portfolio.push_back({ true, true, true, true, true }); // Exchange pruning pays off on heavily correlated features
+    portfolio.push_back({ true, true, false, true, true }); // Threshold-only exchange for ordinal-dominated datasets
+    portfolio.push_back({ true, true, false, false, false }); // Cancellation propagation can thrash on deep graphs
+
+    unsigned int const saved_time_limit = Configuration::time_limit();
+    Configuration::time_limit() = std::max(1u, Configuration::autotune_budget());
+    if (Configuration::verbose()) {
+        std::cout << "Autotuning Bound Flags: " << portfolio.size() << " candidates, "
+            << Configuration::time_limit() << " second(s) each" << std::endl;
+    }
+
+    std::vector< float > gaps(portfolio.size(), 0.0);
+    std::vector< float > durations(portfolio.size(), 0.0);
+    for (unsigned int candidate = 0; candidate < portfolio.size(); ++candidate) {
+        Candidate const & flags = portfolio[candidate];
+        if (candidate > 0
+            && flags.look_ahead == configured.look_ahead
+            && flags.similar_support == configured.similar_support
+            && flags.feature_exchange == configured.feature_exchange
+            && flags.continuous_feature_exchange == configured.continuous_feature_exchange
+            && flags.cancellation == configured.cancellation) { continue; } // Already probed as the configured entry
+        Configuration::look_ahead() = flags.look_ahead;
+        Configuration::similar_support() = flags.similar_support;
+        Configuration::feature_exchange() = flags.feature_exchange;
+        Configuration::continuous_feature_exchange() = flags.continuous_feature_exchange;
+        Configuration::cancellation() = flags.cancellation;
+
+        // Each probe runs on a fresh optimizer over fresh search structures; the loaded
+        // dataset is reused, so a probe restart only pays for graph and queue construction
+        Optimizer probe;
+        probe.retain_dataset = true;
+        probe.load();
+        probe.initialize();
+        std::vector< std::thread > workers;
+        std::vector< int > iterations(Configuration::worker_limit());
+        if (Configuration::worker_limit() > 1) {
+            for (unsigned int i = 0; i < Configuration::worker_limit(); ++i) {
+                workers.emplace_back(work, i, std::ref(* this), std::ref(probe), std::ref(iterations[i]));
+            }
+            for (auto iterator = workers.begin(); iterator != workers.end(); ++iterator) { (* iterator).join(); }
+        } else {
+            work(0, * this, probe, iterations[0]);
+        }
+
+        float lowerbound, upperbound;
+        probe.objective_boundary(& lowerbound, & upperbound);
+        gaps[candidate] = std::max((float)(0.0), upperbound - lowerbound);
+        durations[candidate] = std::max((float)(0.001), probe.elapsed());
+        if (Configuration::verbose()) {
+            std::cout << "Autotune Candidate " << candidate
+                << ": Gap: " << gaps[candidate] << ", Time: " << durations[candidate] << std::endl;
+        }
+    }
+
+    // Score by bound-gap progress per second against the least-converged probe, so the
+    // (identical) starting gap cancels out of the ranking; when every probe converges, the
+    // fastest convergence wins instead
+    float const baseline = * std::max_element(gaps.begin(), gaps.end());
+    unsigned int winner = 0;
+    float best = -std::numeric_limits<float>::max();
+    for (unsigned int candidate = 0; candidate < portfolio.size(); ++candidate) {
+        if (durations[candidate] == 0.0) { continue; } // Skipped duplicate of the configured entry
+        float const score = baseline > 0.0
+            ? (baseline - gaps[candidate]) / durations[candidate]
+            : (float)(1.0) / durations[candidate];
+        if (score > best) { best = score; winner = candidate; }
+    }
+
+    Configuration::look_ahead() = portfolio[winner].look_ahead;
+    Configuration::similar_support() = portfolio[winner].similar_support;
+    Configuration::feature_exchange() = portfolio[winner].feature_exchange;
+    Configuration::continuous_feature_exchange() = portfolio[winner].continuous_feature_exchange;
+    Configuration::cancellation() = portfolio[winner].cancellation;
+    Configuration::time_limit() = saved_time_limit;
+    if (Configuration::verbose()) {
+        std::cout << "Autotune Winner: Candidate " << winner
+            << ", look_ahead: " << portfolio[winner].look_ahead
+            << ", similar_support: " << portfolio[winner].similar_support
+            << ", feature_exchange: " << portfolio[winner].feature_exchange
+            << ", continuous_feature_exchange: " << portfolio[winner].continuous_feature_exchange
+            << ", cancellation: " << portfolio[winner].cancellation << std::endl;
+    }
+
+    // Rebuild the search structures the probes consumed, leaving the full solve a clean start
+    optimizer.load();
+}
+
+void GOSDT::solve(Optimizer & optimizer, std::unordered_set< Model > & models, std::function< void(Model &) > const & emit) {
+    int const n = State::dataset().size();
+    if(Configuration::regularization() < (float) 1/n) {
+        std::cout << "Regularization smaller than 1/(num_samples) - this may lead to longer training time if not adjusted." << std::endl;
+        if (!Configuration::allow_small_reg()) {
+            std::cout << "Regularization increased to 1/(num_samples) = " << (1/n) << ". To allow regularization below this, set allow_small_reg to true" << std::endl;
+            Configuration::regularization() = (float) 1/n;
+        }
+    }
+
+    GOSDT::time = 0.0;
+    GOSDT::size = 0;
+    GOSDT::iterations = 0;
+    GOSDT::status = 0;
+
+    std::vector< std::thread > workers;
+    std::vector< int > iterations(Configuration::worker_limit());
+
+    if(Configuration::verbose()) { std::cout << "Starting Optimization" << std::endl; }
+
+//    static struct rusage usage_start, usage_end;
+//    if (getrusage(RUSAGE_SELF, &usage_start)) {
+//         std::cout << "WARNING: rusage returned non-zero value" << std::endl;
+//    }
+
+    // A sweep solves a descending sequence of regularizations in one process, re-seeding
+    // the dependency graph between solves instead of resetting the optimization state
+    std::vector< float > lambdas;
+    if (Configuration::regularization_sweep().empty()) {
+        lambdas.emplace_back(Configuration::regularization());
+    } else {
+        lambdas = Configuration::regularization_sweep();
+        if (!Configuration::allow_small_reg()) { // Apply the same floor as a single-regularization run
+            for (auto iterator = lambdas.begin(); iterator != lambdas.end(); ++iterator) {
+                * iterator = std::max(* iterator, (float) 1/n);
+            }
+        }
+        std::sort(lambdas.begin(), lambdas.end(), std::greater< float >());
+        lambdas.erase(std::unique(lambdas.begin(), lambdas.end()), lambdas.end());
+    }
+
+    Configuration::regularization() = lambdas.front();
+
+    // When an emitter is supplied, extraction streams each model through it instead of
+    // filling the model set; only the first model's statistics are retained
+    unsigned int extracted = 0;
+    float first_loss = 0.0, first_complexity = 0.0;
+    std::function< void(Model &) > stream = [&](Model & model) {
+        if (extracted == 0) {
+            first_loss = model.loss();
+            first_complexity = model.complexity();
+        }
+        extracted += 1;
+        emit(model);
+    };
+
+    // Probe for the best bound-flag combination before committing to the full solve; the
+    // probes consume and rebuild the search structures, so this precedes checkpoint restoration
+    if (Configuration::autotune()) { autotune(optimizer); }
+
+    if (Configuration::checkpoint() != "" && optimizer.restore()) {
+        if(Configuration::verbose()) { std::cout << "Resuming from Checkpoint: " << Configuration::checkpoint() << std::endl; }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (unsigned int round = 0; round < lambdas.size(); ++round) {
+        if (round > 0) {
+            float previous = Configuration::regularization();
+            Configuration::regularization() = lambdas[round];
+            optimizer.refresh(previous);
+            if(Configuration::verbose()) { std::cout << "Continuing Sweep with Regularization: " << lambdas[round] << std::endl; }
+        }
+
+        optimizer.initialize();
+        if (Configuration::worker_limit() > 1) {
+            for (unsigned int i = 0; i < Configuration::worker_limit(); ++i) {
+                workers.emplace_back(work, i, std::ref(* this), std::ref(optimizer), std::ref(iterations[i]));
+//                #ifndef __APPLE__
+//                // If using Ubuntu Build, we can pin each thread to a specific CPU core to improve cache locality
+//                cpu_set_t cpuset; CPU_ZERO(&cpuset); CPU_SET(i, &cpuset);
+//                int error = pthread_setaffinity_np(workers[i].native_handle(), sizeof(cpu_set_t), &cpuset);
+//                if (error != 0) { std::cerr << "Error calling pthread_setaffinity_np: " << error << std::endl; }
+//                #endif
+            }
+            for (auto iterator = workers.begin(); iterator != workers.end(); ++iterator) { (* iterator).join(); } // Wait for the thread pool to terminate
+            workers.clear();
+        }else {
+            work(0, * this, optimizer, iterations[0]);
+        }
+
+        if (round + 1 < lambdas.size()) {
+            // Collect this regularization's models before the bounds are re-seeded
+            try {
+                if (emit) { optimizer.models(stream); } else { optimizer.models(models); }
+            } catch (IntegrityViolation exception) {
+                GOSDT::status = 1;
+                std::cout << exception.to_string() << std::endl;
+            }
+        }
+    }
+
+    GOSDT::status = std::max(GOSDT::status, (unsigned int)(State::status())); // Adopt failures reported by workers
+
+    auto stop = std::chrono::high_resolution_clock::now(); // Stop measuring training time
+// FIREWOLF: Incompatible with Windows MSVC
+//    if (getrusage(RUSAGE_SELF, &usage_end)) {
+//        std::cout << "WARNING: rusage returned non-zero value" << std::endl;
+//        GOSDT::ru_utime = -1;
+//        GOSDT::ru_stime = -1;
+//        GOSDT::ru_maxrss = -1;
+//        GOSDT::ru_nswap = -1;
+//        GOSDT::ru_nivcsw = -1;
+//    } else {
+//        struct timeval delta;
+//        timersub(&usage_end.ru_utime, &usage_start.ru_utime, &delta);
+//        GOSDT::ru_utime = (float)delta.tv_sec + (((float)delta.tv_usec) / 1000000);
+//        timersub(&usage_end.ru_stime, &usage_start.ru_stime, &delta);
+//        GOSDT::ru_stime = (float)delta.tv_sec + (((float)delta.tv_usec) / 1000000);
+//        GOSDT::ru_maxrss = usage_end.ru_maxrss;
+//        GOSDT::ru_nswap = usage_end.ru_nswap - usage_start.ru_nswap;
+//        GOSDT::ru_nivcsw = usage_end.ru_nivcsw - usage_start.ru_nivcsw;
+//    }
+    GOSDT::time = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() / 1000.0;
+    if(Configuration::verbose()) { std::cout << "Optimization Complete" << std::endl; }
+
+    for (auto iterator = iterations.begin(); iterator != iterations.end(); ++iterator) { GOSDT::iterations += * iterator; }
+    GOSDT::size = optimizer.size();
+    float lowerbound, upperbound;
+    optimizer.objective_boundary(& lowerbound, & upperbound);
+    GOSDT::lower_bound = lowerbound;
+    GOSDT::upper_bound = upperbound;
+
+    if(Configuration::verbose()) { std::cout << "Optimization Complete" << std::endl; }
+
+
+    if (Configuration::timing() != "") {
+        std::ofstream timing_output(Configuration::timing(), std::ios_base::app);
+        timing_output << GOSDT::time;
+        timing_output.flush();
+        timing_output.close();
+    }
+
+    if(Configuration::verbose()) {
+        std::cout << "Training Duration: " << GOSDT::time << " seconds" << std::endl;
+        std::cout << "Number of Iterations: " << GOSDT::iterations << " iterations" << std::endl;
+        std::cout << "Size of Graph: " << GOSDT::size << " nodes" << std::endl;
+        std::cout << "Training Duration (user time): " <<  GOSDT::ru_utime << " seconds" << std::endl;
+        std::cout << "Training Duration (system time)" << GOSDT::ru_stime << " seconds" << std::endl;
+        std::cout << "Maximim memory: " << GOSDT::ru_utime  << " kB" << std::endl;
+        std::cout << "Number of swaps" << GOSDT::ru_nswap << std::endl;
+        std::cout << "Size of Search Graph: " << optimizer.size() << " nodes" << std::endl;
+        std::cout << "Objective Boundary: [" << lowerbound << ", " << upperbound << "]" << std::endl;
+        std::cout << "Optimality Gap: " << optimizer.uncertainty() << std::endl;
+    }
+
+    try {
+        if (!optimizer.complete()) {
+            // there might be a timeout here...
+            if (optimizer.out_of_memory()) {
+                std::cout << "memory limit reached: returning best model with gap [" << lowerbound << " .. " << upperbound << "]" << std::endl;
+                GOSDT::status = 2;
+            } else if (GOSDT::time > (float)Configuration::time_limit() || !State::queue().empty()) {
+                std::cout << "possible timeout: " << GOSDT::time << " " << Configuration::time_limit() << " queue emtpy: "  << State::queue().empty() << std::endl;
+                GOSDT::status = 2;
+            } else {
+                std::cout << "possible non-convergence: [" << lowerbound << " .. " << upperbound << "]" << std::endl;
+                GOSDT::status = 1;
+            }
+
+            if (Configuration::diagnostics()) {
+                std::cout << "Non-convergence Detected. Beginning Diagnosis" << std::endl;
+                optimizer.diagnose_non_convergence();
+                std::cout << "Diagnosis complete" << std::endl;
+            }
+        }
+
+        if (emit) { optimizer.models(stream); } else { optimizer.models(models); }
+
+        unsigned int const generated = emit ? extracted : models.size();
+        if (Configuration::model_limit() > 0 && generated == 0) {
+            GOSDT::status = 1;
+            if (Configuration::diagnostics()) {
+                std::cout << "False-convergence Detected. Beginning Diagnosis" << std::endl;
+                optimizer.diagnose_false_convergence();
+                std::cout << "Diagnosis complete" << std::endl;
+            }
+            throw IntegrityViolation("No model","No model found - either user-provided upper bound assumption was too strong, or there was a false convergence");
+        }
+
+        if (Configuration::verbose()) {
+            std::cout << "Models Generated: " << generated << std::endl;
+            if (optimizer.uncertainty() == 0.0 && generated > 0) {
+                std::cout << "Loss: " << (emit ? first_loss : models.begin() -> loss()) << std::endl;
+                std::cout << "Complexity: " << (emit ? first_complexity : models.begin() -> complexity()) << std::endl;
+            }
+        }
+        GOSDT::model_loss = emit ? first_loss : models.begin() -> loss();
+        if (!emit && Configuration::model() != "") {
+            json output = json::array();
+            for (auto iterator = models.begin(); iterator != models.end(); ++iterator) {
+                Model model = * iterator;
+                json object = json::object();
+                model.to_json(object);
+                output.push_back(object);
+            }
+            if(Configuration::verbose()) { std::cout << "Storing Models in: " << Configuration::model() << std::endl; }
+            Writer::write(Configuration::model(), output.dump(2));
+        }
+        if (!emit && Configuration::binary_model() != "") {
+            std::string buffer;
+            for (auto iterator = models.begin(); iterator != models.end(); ++iterator) {
+                iterator -> to_binary(buffer);
+            }
+            if(Configuration::verbose()) { std::cout << "Storing Binary Models in: " << Configuration::binary_model() << std::endl; }
+            Model::save_binary(Configuration::binary_model(), buffer, models.size());
+        }
+    } catch (IntegrityViolation exception) {
+        GOSDT::status = 1;
+        std::cout << exception.to_string() << std::endl;
+    }
+
+    // Drain any outstanding trace, tree, or model writes so every file produced by this run
+    // exists once fit returns; workers have already joined, so nothing here blocks the search
+    Writer::flush();
+}
+
+
+void GOSDT::work(int const id, GOSDT & instance, Optimizer & optimizer, int & return_reference) {
+    // Bind this worker to the owning instance before touching any state
+    State::bind(& instance.context);
+    Configuration::bind(& instance.settings);
+#if defined(__linux__)
+    if (Configuration::worker_limit() > 1) {
+        // Pin the worker before it touches any scratch memory so first-touch pages land on
+        // the core's NUMA node; without this, dual-socket runs place half the buffers remotely
+        cpu_set_t cpuset; CPU_ZERO(&cpuset); CPU_SET(id % std::thread::hardware_concurrency(), &cpuset);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        if (error != 0) { std::cerr << "Error calling pthread_setaffinity_np: " << error << std::endl; }
+    }
+#endif
+    // First-touch initialization of this worker's scratch buffers (idempotent across sweep rounds)
+    State::locals()[id].initialize(State::dataset().height(), State::dataset().width(), State::dataset().depth());
+    unsigned int iterations = 0;
+    try {
+        while (optimizer.iterate(id)) { iterations += 1; }
+    } catch( IntegrityViolation exception ) {
+        State::status() = 1;
+        std::cout << exception.to_string() << std::endl;
+        throw std::move(exception);
+    }
+    return_reference += iterations; // Accumulates across the rounds of a regularization sweep
+}
@@ -4,6 +4,7 @@
 #define SIMDPP_ARCH_X86_SSE4_1
 
 #include <iostream>
+#include <algorithm>
 
 #include <thread>
 //#include <pthread.h>
@@ -14,6 +15,7 @@
 //#include <boost/dynamic_bitset.hpp>
 #include <vector>
 #include <string>
+#include <functional>
 
 //#include <alloca.h>
 
@@ -24,29 +26,34 @@
 #include "integrity_violation.hpp"
 #include "model.hpp"
 #include "optimizer.hpp"
+#include "state.hpp"
+#include "writer.hpp"
 
 using json = nlohmann::json;
 
 // The main interface of the library
-// Note that the algorithm behaviour is modified using the static configuration object using the Configuration class
+// Note that the algorithm behaviour is modified using the Configuration class
+// Each instance owns its optimization state and configuration, so separate instances can
+// run fits concurrently in one process, each with its own worker pool
 class GOSDT {
     public:
         GOSDT(void);
         ~GOSDT(void);
 
-        static float time;
-        static unsigned int size;
-        static unsigned int iterations;
-        static unsigned int status;
-        static double lower_bound;
-        static double upper_bound;
-        static float model_loss; //loss of tree(s) returned
+        // Results of the most recent fit run by the calling thread
+        static thread_local float time;
+        static thread_local unsigned int size;
+        static thread_local unsigned int iterations;
+        static thread_local unsigned int status;
+        static thread_local double lower_bound;
+        static thread_local double upper_bound;
+        static thread_local float model_loss; //loss of tree(s) returned
 
-        static float  ru_utime;         /* user CPU time used */
-        static float  ru_stime;         /* system CPU time used */
-        static long   ru_maxrss;        /* maximum resident set size in KB */
-        static long   ru_nswap;         /* swaps */
-        static long   ru_nivcsw;        /* involuntary context switches */
+        static thread_local float  ru_utime;         /* user CPU time used */
+        static thread_local float  ru_stime;         /* system CPU time used */
+        static thread_local long   ru_maxrss;        /* maximum resident set size in KB */
+        static thread_local long   ru_nswap;         /* swaps */
+        static thread_local long   ru_nivcsw;        /* involuntary context switches */
 
         // @param config_source: string stream containing a JSON object of configuration parameters
         // @note: See the Configuration class for details about each parameter
@@ -61,6 +68,18 @@ class GOSDT {
         // @modifies result: Contains a JSON array of all optimal models extracted
         void fit(std::istream & data_source, std::string & result);
 
+        // @param keep: when set, fits on this instance keep the loaded dataset in the
+        //        instance context after the optimizer tears down, so a later fit without a
+        //        data source can reuse it; the search structures are still released
+        void retain(bool keep);
+
+        // @require an earlier fit on this instance already loaded a dataset
+        // @modifies result: Contains a JSON array of all optimal models extracted
+        // @note reuses the dataset held by this instance, so only the configuration staged on
+        //       the calling thread changes between fits; the configuration must shape the
+        //       dataset the same way as the fit that loaded it (costs, weights, encoding)
+        void fit(std::string & result);
+
         // @require: The CSV must contain a header.
         // @require: Scientific notation is currently not supported by the parser, use long form decimal notation
         // @require: All rows must have the same number of entries
@@ -69,11 +88,53 @@ class GOSDT {
         // @param data_source: string containing a CSV of training_data
         // @modifies models: Set of models extracted from the optimization
         void fit(std::istream & data_source, std::unordered_set< Model > & models);
+
+        // @param matrix: row-major samples x columns matrix of bytes where the first
+        //   columns - 1 entries of each row are 0/1 feature indicators and the last
+        //   entry is the class label
+        // @modifies result: Contains a JSON array of all optimal models extracted
+        // @note avoids any CSV serialization or parse of data that is already binarized
+        void fit(unsigned char const * matrix, unsigned int samples, unsigned int columns, std::string & result);
+
+        // @param matrix: row-major samples x columns matrix of bytes where the first
+        //   columns - 1 entries of each row are 0/1 feature indicators and the last
+        //   entry is the class label
+        // @modifies models: Set of models extracted from the optimization
+        void fit(unsigned char const * matrix, unsigned int samples, unsigned int columns, std::unordered_set< Model > & models);
     private:
+        State::Context context; // The optimization state owned by this instance
+        Configuration::Values settings; // The configuration owned by this instance
+        bool retained = false; // Whether fits keep the loaded dataset for reuse
+
+        // @modifies binds this instance's context and configuration to the calling thread
+        //           in preparation for loading a dataset
+        void bind(void);
+
+        // @param optimizer: optimizer which has already loaded the dataset
+        // @modifies runs one short time-boxed probe solve per candidate combination of the
+        //   bound flags, reusing the loaded dataset across probes, scores each probe by
+        //   bound-gap progress per second, and stages the winning combination in the active
+        //   configuration; the search structures are reset for the full solve that follows
+        void autotune(Optimizer & optimizer);
+
+        // @param optimizer: optimizer which has already loaded the dataset
+        // @param models: Set of models extracted from the optimization; left empty when emit is set
+        // @param emit: optional callback which receives each model as it is extracted, so
+        //   callers that only serialize never hold the full model set in memory
+        // @modifies runs the optimization to completion and extracts the models
+        void solve(Optimizer & optimizer, std::unordered_set< Model > & models, std::function< void(Model &) > const & emit = nullptr);
+
+        // @param optimizer: optimizer which has already loaded the dataset
+        // @param result: Contains a JSON array of all optimal models extracted
+        // @modifies runs the optimization and streams each model into result as it is
+        //   extracted, instead of materializing the model set first
+        void serialize(Optimizer & optimizer, std::string & result);
+
         // @param id: The worker ID of the current thread
+        // @param instance: the instance whose context and configuration the thread binds to
         // @param optimizer: optimizer object which will assign work to the thread
         // @modifies return_reference: reference for returning values to the main thread
-        static void work(int const id, Optimizer & optimizer, int & return_reference);
+        static void work(int const id, GOSDT & instance, Optimizer & optimizer, int & return_reference);
 };
 
 #endif
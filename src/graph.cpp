@@ -1,9 +1,109 @@
 #include "graph.hpp"
+#include "state.hpp"
+
+#include <fstream>
+#include <limits>
+#include <unistd.h>
 
 Graph::Graph(void) {}
 
 Graph::~Graph(void) {}
 
+Graph & Graph::operator=(Graph const & other) {
+    this -> translations = other.translations;
+    this -> children = other.children;
+    this -> vertices = other.vertices;
+    this -> edges = other.edges;
+    this -> bounds = other.bounds;
+    this -> interned = other.interned;
+    this -> condemned.clear();
+    return * this;
+}
+
+unsigned int Graph::intern(key_type const & key) {
+    return (unsigned int)(this -> interned.push_back(key) - this -> interned.begin());
+}
+
+key_type const & Graph::identifier(unsigned int index) const {
+    return this -> interned[index];
+}
+
+unsigned int Graph::interned_count(void) const {
+    return (unsigned int)(this -> interned.size());
+}
+
+// Hashes translations by content so equal orderings intern to the same shared copy
+class TranslationHashComparator {
+public:
+    static size_t hash(translation_type const & order) {
+        size_t seed = order.size();
+        for (auto iterator = order.begin(); iterator != order.end(); ++iterator) {
+            seed ^= (size_t)(* iterator) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+    static bool equal(translation_type const & left, translation_type const & right) {
+        return left == right;
+    }
+};
+
+shared_translation Graph::translation(translation_type const & order) {
+    // The pool outlives any one fit, like the message pool; translations are tiny relative
+    // to the vertices that reference them, so they are never reclaimed
+    static tbb::concurrent_hash_map< translation_type, shared_translation, TranslationHashComparator,
+        tbb::scalable_allocator< std::pair< translation_type const, shared_translation > > > pool;
+    if (order.empty()) { return shared_translation(); }
+    {
+        decltype(pool)::const_accessor interned_order;
+        if (pool.find(interned_order, order)) { return interned_order -> second; }
+    }
+    decltype(pool)::accessor interned_order;
+    if (pool.insert(interned_order, order)) {
+        interned_order -> second = std::make_shared< translation_type const >(order);
+    }
+    return interned_order -> second;
+}
+
+void Graph::condemn(key_type const & key) {
+    this -> condemned.push(key);
+}
+
+unsigned int Graph::collect(void) {
+    unsigned int reclaimed = 0;
+    int const width = State::dataset().width();
+    key_type key;
+    while (this -> condemned.try_pop(key)) {
+        { // Re-check the condemnation under the vertex lock; the vertex may have been
+          // recreated with a wider scope since it was condemned
+            vertex_accessor vertex;
+            if (!(this -> vertices.find(vertex, key))) { continue; }
+            if (vertex -> second.lowerbound() < vertex -> second.upperscope() - std::numeric_limits<float>::epsilon()) { continue; }
+            this -> vertices.erase(vertex);
+        }
+        // The vertex entry is erased first, so dispatches that still find it hold its lock
+        // until they finish; everything below is only reachable through the vertex
+        this -> bounds.erase(key);
+        this -> edges.erase(key);
+        for (int j = 1; j <= width; ++j) {
+            this -> children.erase(std::make_pair(key, j));
+            this -> children.erase(std::make_pair(key, -j));
+            this -> translations.erase(std::make_pair(key, j));
+            this -> translations.erase(std::make_pair(key, -j));
+        }
+        reclaimed += 1;
+    }
+    return reclaimed;
+}
+
+unsigned int Graph::memory_usage(void) {
+    std::ifstream statm("/proc/self/statm");
+    if (!statm.good()) { return 0; }
+    unsigned long long total_pages, resident_pages;
+    statm >> total_pages >> resident_pages;
+    if (!statm.good()) { return 0; }
+    return resident_pages * (sysconf(_SC_PAGESIZE) >> 10) >> 10;
+}
+
 // bool Graph::exists(key_type const & key) const {
 //     return this -> vertices.count(key) != 0;
 // }
@@ -196,6 +296,7 @@ void Graph::clear(void) {
     this -> children.clear();
     this -> vertices.clear();
     this -> bounds.clear();
+    this -> interned.clear();
     return;
 }
 
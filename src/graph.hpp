@@ -6,11 +6,13 @@
 #include "tile.hpp"
 
 #include <iostream>
+#include <limits>
 #include <utility>
 #include <vector>
 #include <tuple>
 
 #include <tbb/concurrent_hash_map.h>
+#include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_vector.h>
 #include <tbb/scalable_allocator.h>
@@ -19,7 +21,9 @@
 
 typedef Tile key_type;
 typedef Task value_type;
-typedef std::vector<int> translation_type;
+
+// Sentinel for references that have not been bound to an interned vertex yet
+unsigned int const unindexed_vertex = std::numeric_limits<unsigned int>::max();
 
 // Additional Hash Implementation for tbb::concurrent_hash_table
 // These delegate to the already implemented hash functions and equality operators
@@ -57,13 +61,13 @@ public:
     }
 };
 
-typedef tbb::concurrent_hash_map< // Table for storing forward edges
-    std::pair<key_type, int>, key_type, GraphChildHashComparator, 
-    tbb::scalable_allocator<std::pair<std::pair<key_type, int> const, key_type>>> child_table;
+typedef tbb::concurrent_hash_map< // Table for storing forward edges, child vertices referenced by interned index
+    std::pair<key_type, int>, unsigned int, GraphChildHashComparator,
+    tbb::scalable_allocator<std::pair<std::pair<key_type, int> const, unsigned int>>> child_table;
 
-typedef tbb::concurrent_hash_map< // Table for storing tile-orderings
-    std::pair<key_type, int>, translation_type, GraphChildHashComparator, 
-    tbb::scalable_allocator<std::pair<std::pair<key_type, int> const, translation_type>>> translation_table;
+typedef tbb::concurrent_hash_map< // Table for storing tile-orderings, shared with the interning pool
+    std::pair<key_type, int>, shared_translation, GraphChildHashComparator,
+    tbb::scalable_allocator<std::pair<std::pair<key_type, int> const, shared_translation>>> translation_table;
 
 typedef tbb::concurrent_hash_map< // Table for storing vertices
     key_type, value_type, GraphVertexHashComparator, 
@@ -77,7 +81,10 @@ typedef tbb::concurrent_hash_map< // Table of all adjacency sets
     key_type, adjacency_set, GraphVertexHashComparator,
     tbb::scalable_allocator<std::pair<key_type const, adjacency_set>>> adjacency_table;
 
-typedef tbb::concurrent_vector<std::tuple<unsigned int, float, float>, tbb::scalable_allocator<std::tuple<unsigned int, float, float>>> bound_list; // List of split-bounds for a single vertex
+// List of split-bounds for a single vertex: (feature, lowerbound, upperbound) plus the
+// interned indices of the negative and positive child, cached on first look-up through the
+// child table so later visits reach each child vertex with a single hash look-up
+typedef tbb::concurrent_vector<std::tuple<unsigned int, float, float, unsigned int, unsigned int>, tbb::scalable_allocator<std::tuple<unsigned int, float, float, unsigned int, unsigned int>>> bound_list;
 
 typedef tbb::concurrent_hash_map< // Table of all bound lists
     key_type, bound_list, GraphVertexHashComparator, 
@@ -121,6 +128,10 @@ public:
     Graph(void);
     ~Graph(void);
 
+    // Replaces the table contents; pending condemnations are discarded
+    // (tbb::concurrent_queue is not assignable, and condemned keys are meaningless across resets)
+    Graph & operator=(Graph const & other);
+
     // bool exists(key_type const & key) const;
     
     // bool insert(key_type const & key, value_type const & value);
@@ -141,11 +152,57 @@ public:
     // Bitmask & buffer_1, Bitmask & buffer_2, Bitmask & buffer_3,
     // Task const & task, unsigned int index, bool condition);
 
+    // @param key: identifier of a vertex that was just stored
+    // @returns a dense index assigned to the vertex, through which secondary tables
+    //          reference it without copying the identifier
+    // @note indices are never reused; a stale index left behind by a collection pass
+    //       resolves through the retained identifier, so it either misses or reaches a
+    //       recreated vertex for the same subproblem, exactly as a retained key would
+    unsigned int intern(key_type const & key);
+
+    // @param index: a dense index previously returned by intern
+    // @returns the identifier of the interned vertex; the reference stays valid for the
+    //          lifetime of the solve, since interned identifiers are never relocated
+    key_type const & identifier(unsigned int index) const;
+
+    // @returns the number of identifiers interned so far; unlike the vertex table, the
+    //          interned vector only grows, so every index below the returned count stays
+    //          resolvable through identifier while workers continue to insert, which makes
+    //          this the traversal-safe way to enumerate vertices during a solve
+    unsigned int interned_count(void) const;
+
+    // @param order: a translation mapping canonical column positions to stored indices
+    // @returns a shared handle to the interned copy of order, so equal translations are
+    //          stored once and shared by reference thereafter; an empty order yields the
+    //          null handle denoting the identity
+    static shared_translation translation(translation_type const & order);
+
     bool erase(key_type const & key, bool disconnect = true);
     bool disconnect(key_type const & arent, key_type const & child);
     void clear(void);
 
     unsigned int size(void) const;
+
+    // @param key: identifier of a vertex observed to be provably excluded from any optimal tree
+    // @modifies marks the vertex for reclamation by the next collection pass
+    void condemn(key_type const & key);
+
+    // @modifies erases condemned vertices that are still dominated from all five tables
+    // @returns the number of vertices reclaimed
+    // @note safe to run while workers continue; per-key erasure waits on outstanding accessors,
+    //       and dangling references left in other vertices' entries are tolerated by dispatch
+    unsigned int collect(void);
+
+    // @returns the resident set size of the process in megabytes, or 0 if unavailable
+    static unsigned int memory_usage(void);
+
+private:
+    // Identifiers of interned vertices, positioned by their dense index; grows monotonically
+    // so outstanding indices in secondary tables never dangle
+    tbb::concurrent_vector< key_type, tbb::scalable_allocator< key_type > > interned;
+
+    // Vertices awaiting reclamation, appended concurrently by workers during dispatch
+    tbb::concurrent_queue< key_type > condemned;
 };
 
 #endif
@@ -1,5 +1,158 @@
 #include "index.hpp"
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define INDEX_RUNTIME_SIMD
+#include <immintrin.h>
+#endif
+
+// ********************************
+// ** Vectorized Kernel Backend  **
+// ********************************
+// Runtime-dispatched implementations of the prefix-sum gather kernel
+// Runs of set bits are extracted from the mask words with count-trailing-zero scans;
+// each run contributes prefixes[finish] - prefixes[start], and the boundaries are
+// buffered so the subtractions can be performed with vector gathers in batches
+
+namespace {
+    typedef void (* gather_kernel)(float const * prefixes, unsigned int width,
+        bitblock const * blocks, unsigned int count, unsigned int size, float * accumulator);
+
+    unsigned int const bits_per_word = 8 * sizeof(bitblock);
+
+    // @param blocks: array of mask words with unused trailing bits cleared
+    // @param count: the number of words in blocks
+    // @param size: the number of valid bits across blocks
+    // @param starts, finishes: output buffers for run boundaries, at least capacity elements each
+    // @param capacity: the maximum number of runs to extract per call
+    // @param cursor: scan position in bits, advanced across calls
+    // @param inside, run_start: scan state carried across calls
+    // @returns the number of runs written into starts/finishes
+    unsigned int extract_runs(bitblock const * blocks, unsigned int count, unsigned int size,
+        int * starts, int * finishes, unsigned int capacity,
+        unsigned int & cursor, bool & inside, unsigned int & run_start) {
+        unsigned int pending = 0;
+        size = std::min(size, count * bits_per_word); // Never scan past the block array, whatever size claims
+        while (pending < capacity && cursor < size) {
+            unsigned int word_index = cursor / bits_per_word;
+            unsigned int bit_index = cursor % bits_per_word;
+            bitblock word = inside ? ~(blocks[word_index]) : blocks[word_index];
+            word >>= bit_index;
+            if (word == 0) { // The current run (of either sign) continues through this word
+                cursor = (word_index + 1) * bits_per_word;
+                continue;
+            }
+            cursor += __builtin_ctzll(word);
+            if (inside) {
+                starts[pending] = run_start;
+                finishes[pending] = std::min(cursor, size);
+                pending += 1;
+            } else {
+                run_start = std::min(cursor, size); // Clamp in case of stray bits beyond size
+            }
+            inside = !inside;
+        }
+        if (pending < capacity && inside) { // Close the final run at the end of the mask
+            starts[pending] = run_start;
+            finishes[pending] = size;
+            pending += 1;
+            inside = false;
+        }
+        return pending;
+    }
+
+    // Portable backend applying each run boundary scalar-by-scalar
+    void scalar_gather_kernel(float const * prefixes, unsigned int width,
+        bitblock const * blocks, unsigned int count, unsigned int size, float * accumulator) {
+        int starts[8], finishes[8];
+        unsigned int cursor = 0, run_start = 0;
+        bool inside = false;
+        unsigned int pending;
+        while ((pending = extract_runs(blocks, count, size, starts, finishes, 8, cursor, inside, run_start)) > 0) {
+            for (unsigned int r = 0; r < pending; ++r) {
+                float const * start = prefixes + starts[r] * width;
+                float const * finish = prefixes + finishes[r] * width;
+                for (unsigned int j = 0; j < width; ++j) { accumulator[j] += finish[j] - start[j]; }
+            }
+        }
+    }
+
+#ifdef INDEX_RUNTIME_SIMD
+    // AVX2 backend gathering 8 run boundaries per instruction
+    __attribute__((target("avx2")))
+    void avx2_gather_kernel(float const * prefixes, unsigned int width,
+        bitblock const * blocks, unsigned int count, unsigned int size, float * accumulator) {
+        int starts[8], finishes[8];
+        unsigned int cursor = 0, run_start = 0;
+        bool inside = false;
+        unsigned int pending;
+        while ((pending = extract_runs(blocks, count, size, starts, finishes, 8, cursor, inside, run_start)) > 0) {
+            if (pending == 8) {
+                __m256i start_rows = _mm256_mullo_epi32(_mm256_loadu_si256((__m256i const *) starts), _mm256_set1_epi32(width));
+                __m256i finish_rows = _mm256_mullo_epi32(_mm256_loadu_si256((__m256i const *) finishes), _mm256_set1_epi32(width));
+                for (unsigned int j = 0; j < width; ++j) {
+                    __m256i column = _mm256_set1_epi32(j);
+                    __m256 start_values = _mm256_i32gather_ps(prefixes, _mm256_add_epi32(start_rows, column), 4);
+                    __m256 finish_values = _mm256_i32gather_ps(prefixes, _mm256_add_epi32(finish_rows, column), 4);
+                    __m256 difference = _mm256_sub_ps(finish_values, start_values);
+                    __m128 folded = _mm_add_ps(_mm256_castps256_ps128(difference), _mm256_extractf128_ps(difference, 1));
+                    folded = _mm_add_ps(folded, _mm_movehl_ps(folded, folded));
+                    folded = _mm_add_ss(folded, _mm_shuffle_ps(folded, folded, 1));
+                    accumulator[j] += _mm_cvtss_f32(folded);
+                }
+            } else { // Partial batch at the end of the mask
+                for (unsigned int r = 0; r < pending; ++r) {
+                    float const * start = prefixes + starts[r] * width;
+                    float const * finish = prefixes + finishes[r] * width;
+                    for (unsigned int j = 0; j < width; ++j) { accumulator[j] += finish[j] - start[j]; }
+                }
+            }
+        }
+    }
+
+    // AVX-512 backend gathering 16 run boundaries per instruction
+    __attribute__((target("avx512f")))
+    void avx512_gather_kernel(float const * prefixes, unsigned int width,
+        bitblock const * blocks, unsigned int count, unsigned int size, float * accumulator) {
+        int starts[16], finishes[16];
+        unsigned int cursor = 0, run_start = 0;
+        bool inside = false;
+        unsigned int pending;
+        while ((pending = extract_runs(blocks, count, size, starts, finishes, 16, cursor, inside, run_start)) > 0) {
+            __mmask16 lanes = (__mmask16)((1 << pending) - 1);
+            __m512i start_rows = _mm512_mullo_epi32(_mm512_maskz_loadu_epi32(lanes, starts), _mm512_set1_epi32(width));
+            __m512i finish_rows = _mm512_mullo_epi32(_mm512_maskz_loadu_epi32(lanes, finishes), _mm512_set1_epi32(width));
+            for (unsigned int j = 0; j < width; ++j) {
+                __m512i column = _mm512_set1_epi32(j);
+                __m512 start_values = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), lanes, _mm512_add_epi32(start_rows, column), prefixes, 4);
+                __m512 finish_values = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), lanes, _mm512_add_epi32(finish_rows, column), prefixes, 4);
+                accumulator[j] += _mm512_reduce_add_ps(_mm512_sub_ps(finish_values, start_values));
+            }
+        }
+    }
+#endif
+
+    // Active backend, overwritten during start-up if a wider instruction set is available
+    gather_kernel sum_kernel = scalar_gather_kernel;
+
+    // Selects the widest backend supported by the host processor
+    struct IndexKernelDispatch {
+        IndexKernelDispatch(void) {
+#ifdef INDEX_RUNTIME_SIMD
+            if (__builtin_cpu_supports("avx512f")) {
+                sum_kernel = avx512_gather_kernel;
+            } else if (__builtin_cpu_supports("avx2")) {
+                sum_kernel = avx2_gather_kernel;
+            }
+#endif
+        }
+    };
+    IndexKernelDispatch const index_kernel_dispatch;
+}
+
+// ********************************
+// ** Function Module Definition **
+// ********************************
+
 Index::Index(void) {}
 
 Index::Index(std::vector< std::vector< float > > const & src) {
@@ -11,6 +164,13 @@ Index::Index(std::vector< std::vector< float > > const & src) {
 
     build_prefixes(src, this -> prefixes);
 
+    this -> flat_prefixes.resize((this -> size + 1) * this -> width, 0.0);
+    for (unsigned int i = 0; i <= this -> size; ++i) {
+        for (unsigned int j = 0; j < this -> width; ++j) {
+            this -> flat_prefixes[i * this -> width + j] = this -> prefixes.at(i).at(j);
+        }
+    }
+
     this -> source.resize(this -> size * this -> width, 0.0);
     for (unsigned int i = 0;  i < this -> size; ++i) {
         for (unsigned int j = 0; j < this -> width; ++j) {
@@ -41,7 +201,7 @@ void Index::build_prefixes(std::vector< std::vector< float > > const & src, std:
 }
 
 void Index::sum(Bitmask const & indicator, float * accumulator) const {
-    bit_sequential_sum(indicator, accumulator);
+    block_vector_sum(indicator.data(), accumulator);
     float const epsilon = std::numeric_limits<float>::epsilon();
     for (unsigned int j = 0; j < this -> width; ++j) {
         if (accumulator[j] < epsilon) { accumulator[j] = 0.0; }
@@ -71,6 +231,10 @@ void Index::bit_sequential_sum(Bitmask const & indicator, float * accumulator) c
     }
 }
 
+void Index::block_vector_sum(bitblock * blocks, float * accumulator) const {
+    sum_kernel(this -> flat_prefixes.data(), this -> width, blocks, this -> num_blocks, this -> size, accumulator);
+}
+
 void Index::block_sequential_sum(bitblock * blocks, float * accumulator) const {
     unsigned int offset = 0;
     for (unsigned int i = 0; i < this -> num_blocks; ++i) {
@@ -126,6 +290,9 @@ std::string Index::to_string(void) const {
 
 void Index::benchmark(void) const
 {
+    // The block sequential implementation reads the run-length-code tables, which no
+    // training path builds, so they are built here on first use
+    Bitmask::precompute();
     Bitmask indicator(this->size, true);
     for (unsigned int i = 0; i < this->size; ++i)
     {
@@ -143,6 +310,23 @@ void Index::benchmark(void) const
     float bit_max = -std::numeric_limits<float>::max();
     float bit_avg;
 
+    float vector_min = std::numeric_limits<float>::max();
+    float vector_max = -std::numeric_limits<float>::max();
+    float vector_avg;
+
+    { // Validate that both paths agree before timing them
+        std::vector<float, tbb::scalable_allocator<float>> sequential_result(this->width, 0.0);
+        std::vector<float, tbb::scalable_allocator<float>> vector_result(this->width, 0.0);
+        bit_sequential_sum(indicator, sequential_result.data());
+        block_vector_sum(blocks, vector_result.data());
+        float deviation = 0.0;
+        for (unsigned int j = 0; j < this->width; ++j) {
+            deviation = std::max(deviation, std::abs(sequential_result.at(j) - vector_result.at(j)));
+        }
+        std::cout << "Index Validation Results: " << std::endl;
+        std::cout << "  Max Deviation (Bit Sequential vs Vector Gather): " << deviation << std::endl;
+    }
+
     auto block_start = std::chrono::high_resolution_clock::now();
     for (unsigned int i = 0; i < sample_size; ++i)
     {
@@ -171,6 +355,20 @@ void Index::benchmark(void) const
     auto bit_finish = std::chrono::high_resolution_clock::now();
     bit_avg = (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(bit_finish - bit_start).count()) / sample_size / 1000;
 
+    auto vector_start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < sample_size; ++i)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        block_vector_sum(blocks, accumulator.data());
+        auto finish = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start);
+
+        vector_min = std::min((float)duration.count() / 1000, vector_min);
+        vector_max = std::max((float)duration.count() / 1000, vector_max);
+    }
+    auto vector_finish = std::chrono::high_resolution_clock::now();
+    vector_avg = (float)(std::chrono::duration_cast<std::chrono::nanoseconds>(vector_finish - vector_start).count()) / sample_size / 1000;
+
     std::cout << "Index Benchmark Results: " << std::endl;
     std::cout << "Block Sequential: " << std::endl;
     std::cout << "  Min: " << block_min << " ms" << std::endl;
@@ -180,6 +378,8 @@ void Index::benchmark(void) const
     std::cout << "  Min: " << bit_min << " ms" << std::endl;
     std::cout << "  Avg: " << bit_avg << " ms" << std::endl;
     std::cout << "  Max: " << bit_max << " ms" << std::endl;
-
-    exit(1);
+    std::cout << "Vector Gather: " << std::endl;
+    std::cout << "  Min: " << vector_min << " ms" << std::endl;
+    std::cout << "  Avg: " << vector_avg << " ms" << std::endl;
+    std::cout << "  Max: " << vector_max << " ms" << std::endl;
 }
@@ -43,6 +43,8 @@ private:
     std::vector< float > source;
     // precomputed representation of the floating point vector
     std::vector< std::vector< float > > prefixes;
+    // Row-major copy of the prefix sums, laid out contiguously so vector gathers can index it directly
+    std::vector< float > flat_prefixes;
     // Number of floating points represented in the source vector
     unsigned int size;
     unsigned int width;
@@ -60,6 +62,13 @@ private:
     // @note: This implementation computes run-length-code for fast sums
     void bit_sequential_sum(Bitmask const &indicator, float *accumulator) const;
 
+    // @param indicator: array of blocks of bits indicating which elements are relevant to the vector sum
+    // @returns the total of all elements associated to bits that were set to 1
+    // @note: This implementation extracts runs directly from the mask words and gathers
+    //        prefix-sum boundaries in batches; the widest backend supported by the host is
+    //        selected once at start-up
+    void block_vector_sum(bitblock * blocks, float * accumulator) const;
+
     // @param source: The original vector of floats used in computation
     // @modifies prefixes: writes the prefix sums into this vector
     void build_prefixes(std::vector< std::vector< float > > const & source, std::vector< std::vector< float > > & prefixes);
@@ -1,16 +1,31 @@
+#include <cstdlib>
+
 #include "local_state.hpp"
+#include "queue.hpp"
 
 LocalState::LocalState(void) {}
 
 void LocalState::initialize(unsigned int _samples, unsigned int _features, unsigned int _targets) {
+    // Idempotent so each worker can initialize its own entry on first use (and again across
+    // the rounds of a regularization sweep) without reallocating its buffers
+    if (this -> rows.size() > 0 && this -> samples == _samples && this -> features == _features && this -> targets == _targets) { return; }
+    this -> rows.clear();
+    this -> columns.clear();
+
     this -> samples = _samples;
     this -> features = _features;
     this -> targets = _targets;
 
     this -> inbound_message.initialize(_samples, _features, _targets);
     this -> outbound_message.initialize(_samples, _features, _targets);
+    this -> inbound_batch.resize(Queue::batch_limit);
+    for (unsigned int i = 0; i < Queue::batch_limit; ++i) {
+        this -> inbound_batch[i].initialize(_samples, _features, _targets);
+    }
     
     this -> neighbourhood.resize(2 * (this -> features));
+    this -> negatives.resize(this -> features);
+    this -> positives.resize(this -> features);
 
     unsigned int buffer_count = 4;
     unsigned int row_size = this -> features + this -> targets;
@@ -21,12 +36,35 @@ void LocalState::initialize(unsigned int _samples, unsigned int _features, unsig
         this -> rows.emplace_back(row_size);
         this -> columns.emplace_back(column_size);
     }
+
+    this -> event_ring.resize(LocalState::event_ring_capacity);
+    this -> snapshot_reservoir.reserve(LocalState::snapshot_reservoir_capacity);
+}
+
+void LocalState::record_dispatch(char code, int feature, float scope, Tile const & identifier) {
+    DiagnosticEvent & event = this -> event_ring[this -> event_cursor % LocalState::event_ring_capacity];
+    event.sequence = this -> event_cursor;
+    event.code = code;
+    event.feature = feature;
+    event.scope = scope;
+    this -> event_cursor += 1;
+
+    // Reservoir sampling (Algorithm R) keeps the snapshots uniform over every dispatch seen
+    this -> snapshot_count += 1;
+    if (this -> snapshot_reservoir.size() < LocalState::snapshot_reservoir_capacity) {
+        this -> snapshot_reservoir.emplace_back(identifier);
+    } else {
+        unsigned long long slot = std::rand() % this -> snapshot_count;
+        if (slot < LocalState::snapshot_reservoir_capacity) { this -> snapshot_reservoir[slot] = identifier; }
+    }
 }
 
 LocalState & LocalState::operator=(LocalState const & source) {
     this -> neighbourhood = source.neighbourhood;
     this -> rows = source.rows;
     this -> columns = source.columns;
+    this -> negatives = source.negatives;
+    this -> positives = source.positives;
     return * this;
 }
 
@@ -8,6 +8,15 @@ class LocalState;
 #include "task.hpp"
 #include "tile.hpp"
 
+// One recent dispatch observation, recorded from the message being processed; the fields
+// are plain scalars so recording costs a handful of stores per dispatch
+struct DiagnosticEvent {
+    unsigned long long sequence; // The worker-local dispatch count when the event was recorded
+    char code; // Message type, one of the Message message-code constants
+    int feature; // The signed feature an exploration travelled along, 0 for exploitations
+    float scope; // The scope budget the message carried
+};
+
 // Container of all data structures the local state owned by each thread
 class LocalState {
 public:
@@ -21,19 +30,52 @@ public:
     //        samples refer to the number of independent samples in a dataset
     //        features refer to the number of binary features that will be available at prediction time
     //        targets refer to the number of different classes that a sample can fall under
+    // @note: idempotent; each worker thread calls this on its own entry so that first-touch
+    //        places the scratch buffers on the worker's NUMA node
     void initialize(unsigned int samples, unsigned int features, unsigned int targets);
     
     LocalState & operator=(LocalState const & source);
 
+    // @param code: the message code of the dispatch being recorded
+    // @param feature: the signed feature of an exploration message, 0 otherwise
+    // @param scope: the scope budget the message carried
+    // @param identifier: the identifier of the vertex the message addressed
+    // @modifies overwrites the oldest slot of the event ring and offers the identifier to
+    //           the snapshot reservoir, keeping it a uniform sample of dispatched vertices
+    void record_dispatch(char code, int feature, float scope, Tile const & identifier);
+
     std::vector< Task > neighbourhood; // Memory buffer for storing children of a node
     Message inbound_message; // Memory buffer for storing a messages from the priority queue
     Message outbound_message; // Memory buffer for storing a messages from the priority queue
+    std::vector< Message > inbound_batch; // Memory buffers for draining a batch of messages per queue visit
     // std::vector< Tile > keys; // Memory buffer for storing a tile representation of a node identifier
     std::vector< Bitmask > rows; // Memory buffer for storing a bitmask representation of a feature set + target set
     std::vector< Bitmask > columns; // Memory buffer for storing a bitmask representation of a capture set
+    std::vector< SplitSummary > negatives; // Memory buffer for storing batched summaries of candidate splits
+    std::vector< SplitSummary > positives; // Memory buffer for storing batched summaries of candidate splits
 
     // Bitmask dirty; // Mask indicating which items in the neighbourhood needs to be written?
-    
+
+    // Cumulative performance tallies owned by this worker; only this worker writes them, and
+    // worker 0 samples them without synchronization when emitting a profile record
+    unsigned long long tally_iterations = 0; // Messages processed
+    unsigned long long tally_explore = 0; // Exploration messages processed
+    unsigned long long tally_exploit = 0; // Exploitation messages processed
+    unsigned long long tally_vertex_hits = 0; // Vertex insertions that found an existing vertex
+    unsigned long long tally_vertex_misses = 0; // Vertex insertions that created a new vertex
+    unsigned long long tally_bound_updates = 0; // Root bound updates that changed the boundary
+    unsigned long long tally_summaries = 0; // Dataset summary scans
+
+    // Sampled diagnosis state owned by this worker, recorded only under
+    // Configuration::diagnostics(); both structures are fixed-size, so the flag can stay
+    // enabled on production runs and an anomaly is the only thing that ever flushes them
+    static unsigned int const event_ring_capacity = 256; // Recent dispatch events retained per worker
+    static unsigned int const snapshot_reservoir_capacity = 64; // Vertex snapshots retained per worker
+    std::vector< DiagnosticEvent > event_ring; // Ring of the most recent dispatch events
+    unsigned long long event_cursor = 0; // Total events recorded; modulo capacity locates the next slot
+    std::vector< Tile > snapshot_reservoir; // Uniform sample of identifiers of dispatched vertices
+    unsigned long long snapshot_count = 0; // Total candidates the reservoir has been offered
+
     unsigned int samples;
     unsigned int features;
     unsigned int targets;
@@ -11,6 +11,17 @@ bool standard_input = false;
 
 	std::cout << "gosdt-" << BUILD_GIT_REV << " (" << BUILD_DATE << " on " << BUILD_HOST << ")" << std::endl;
 
+	// Daemon mode: stay resident and serve fit requests over a unix domain socket,
+	// keeping datasets loaded across requests
+	if (argc >= 2 && std::string(argv[1]) == "--daemon") {
+		if (argc != 3) {
+			std::cout << "Usage: gosdt --daemon [socket path]" << std::endl;
+			return 0;
+		}
+		Daemon daemon;
+		return daemon.serve(argv[2]);
+	}
+
 	// Check program input
 	if ((standard_input && (argc < 1 || argc > 2)) || (!standard_input && (argc < 2 || argc > 3))) {
 		std::cout << "Usage: gosdt [path to feature set] ?[path to config]" << std::endl;
@@ -32,7 +43,7 @@ bool standard_input = false;
 	}
 
 	// Print messages to help user ensure they've provided the correct inputs
-	if (Configuration::verbose) {
+	if (Configuration::verbose()) {
 		std::cout << "Generalized Optimal Sparse Decision Tree" << std::endl;
 		std::cout << "Using data set: " << argv[1] << std::endl;
 	}
@@ -44,6 +55,6 @@ bool standard_input = false;
 		std::ifstream data(argv[1]);
 		model.fit(data, result);
 	}
-	if (Configuration::model == "" || Configuration::verbose) { std::cout << result << std::endl; }
+	if (Configuration::model() == "" || Configuration::verbose()) { std::cout << result << std::endl; }
 	return 0;
 }
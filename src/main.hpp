@@ -13,6 +13,7 @@
 #include <csv/csv.h>
 
 #include "configuration.hpp"
+#include "daemon.hpp"
 #include "gosdt.hpp"
 
 using json = nlohmann::json;
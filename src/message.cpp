@@ -18,10 +18,10 @@ void Message::exploration(Tile const & sender, Bitmask const & recipient_capture
     this -> recipient_capture = recipient_capture;
     this -> recipient_feature = recipient_feature;
     
+    this -> features.clear();
+    this -> signs.clear();
     if (feature != 0) {
-        this -> features.clear();
         this -> features.set(std::abs(feature) - 1, true);
-        this -> signs.clear();
         this -> signs.set(std::abs(feature) - 1, feature > 0);
     }
 
@@ -62,6 +62,21 @@ Message & Message::operator=(Message const & other) {
     return * this;
 };
 
+void Message::swap(Message & other) {
+    this -> sender_tile.swap(other.sender_tile);
+    this -> recipient_tile.swap(other.recipient_tile);
+    this -> recipient_capture.swap(other.recipient_capture);
+    this -> recipient_feature.swap(other.recipient_feature);
+    std::swap(this -> feature, other.feature);
+    this -> features.swap(other.features);
+    this -> signs.swap(other.signs);
+    std::swap(this -> scope, other.scope);
+    std::swap(this -> code, other.code);
+    std::swap(this -> _primary, other._primary);
+    std::swap(this -> _secondary, other._secondary);
+    std::swap(this -> _tertiary, other._tertiary);
+}
+
 bool Message::operator<(Message const & other) const {
     if (this -> _primary != other._primary) {
         return this -> _primary < other._primary;
@@ -45,6 +45,10 @@ public:
     // Assignment operator used to transfer ownership of message data
     Message & operator=(Message const & other);
 
+    // @param other: the message to exchange contents with
+    // @modifies all members are exchanged with other, no heap-backed storage is copied
+    void swap(Message & other);
+
     // Comparison operators used to order messages in the priority queue
     bool operator==(Message const & other) const;
     bool operator<(Message const & other) const;
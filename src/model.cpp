@@ -1,22 +1,66 @@
+#include <cstring>
+#include <fstream>
+
 #include "model.hpp"
 
+namespace {
+    // Binary model file layout: one ModelFileHeader, then for each model an unsigned int
+    // node count followed by that many BinaryModelNode records in preorder
+    // Fields are written in host byte order like the dataset cache, so the file is not
+    // portable across architectures; the record size is validated on load
+    unsigned int const model_version = 1;
+    char const model_magic[8] = { 'G', 'O', 'S', 'D', 'T', 'M', 'D', 'L' };
+    struct ModelFileHeader {
+        char magic[8];
+        unsigned int version;
+        unsigned int node_bytes;
+        unsigned int model_count;
+    };
+
+    // @param node: a subtree of the encoded-space JSON produced by Model::_to_json
+    // @param nodes: the preorder record list under construction
+    // @returns the index of the record appended for this subtree
+    unsigned int flatten(json const & node, std::vector< BinaryModelNode > & nodes) {
+        unsigned int const index = nodes.size();
+        nodes.push_back(BinaryModelNode());
+        if (node.contains("prediction")) {
+            nodes[index].feature = node["prediction"];
+            nodes[index].negative = 0;
+            nodes[index].positive = 0;
+            nodes[index].loss = node["loss"];
+            nodes[index].complexity = node["complexity"];
+        } else {
+            unsigned int const feature = node["feature"];
+            // Recurse before writing the children's indices; recursion may reallocate nodes
+            unsigned int const negative = flatten(node["false"], nodes);
+            unsigned int const positive = flatten(node["true"], nodes);
+            nodes[index].feature = feature;
+            nodes[index].negative = negative;
+            nodes[index].positive = positive;
+            nodes[index].loss = 0.0;
+            nodes[index].complexity = 0.0;
+        }
+        return index;
+    }
+}
+
 Model::Model(void) {}
 
 Model::Model(std::shared_ptr<Bitmask> capture_set) {
     std::string prediction_name, prediction_type, prediction_value;
     float info, potential, min_loss, guaranteed_min_loss, max_loss;
     unsigned int target_index;
-    State::dataset.summary(* capture_set, info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, 0);
-    State::dataset.encoder.target_value(target_index, prediction_value);
-    State::dataset.encoder.header(prediction_name);
-    State::dataset.encoder.target_type(prediction_type);
+    State::dataset().summary(* capture_set, info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, 0);
+    State::dataset().encoder.target_value(target_index, prediction_value);
+    State::dataset().encoder.header(prediction_name);
+    State::dataset().encoder.target_type(prediction_type);
 
     this -> binary_target = target_index;
     this -> name = prediction_name;
     this -> type = prediction_type;
     this -> prediction = prediction_value;
     this -> _loss = max_loss;
-    this -> _complexity = Configuration::regularization;
+    this -> _complexity = Configuration::regularization();
     this -> capture_set = capture_set;
     this -> terminal = true;
 }
@@ -24,9 +68,9 @@ Model::Model(std::shared_ptr<Bitmask> capture_set) {
 Model::Model(unsigned int binary_feature_index, std::shared_ptr<Model> negative, std::shared_ptr<Model> positive) {
     unsigned int feature_index; 
     std::string feature_name, feature_type, relation, reference;
-    State::dataset.encoder.decode(binary_feature_index, & feature_index);                  
-    State::dataset.encoder.encoding(binary_feature_index, feature_type, relation, reference);
-    State::dataset.encoder.header(feature_index, feature_name);
+    State::dataset().encoder.decode(binary_feature_index, & feature_index);                  
+    State::dataset().encoder.encoding(binary_feature_index, feature_type, relation, reference);
+    State::dataset().encoder.header(feature_index, feature_name);
 
     this -> binary_feature = binary_feature_index;
     this -> feature = feature_index;
@@ -47,15 +91,15 @@ void Model::identify(Tile const & identifier) {
 
 bool Model::identified(void) { return this -> identifier.content().size() > 0; }
 
-void Model::translate_self(translation_type const & translation) {
+void Model::translate_self(shared_translation const & translation) {
     this -> self_translator = translation;
 }
 
-void Model::translate_negatives(translation_type const & translation) {
+void Model::translate_negatives(shared_translation const & translation) {
     this -> negative_translator = translation;
 }
 
-void Model::translate_positives(translation_type const & translation) {
+void Model::translate_positives(shared_translation const & translation) {
     this -> positive_translator = translation;
 }
 
@@ -162,6 +206,78 @@ void Model::serialize(std::string & serialization, int const spacing) const {
     return;
 }
 
+void Model::to_binary(std::string & buffer) const {
+    // Reuse the JSON path up to (but excluding) schema decoding, so the tree is flattened in
+    // encoded feature space with any tile-canonicalization reordering already undone
+    json node = json::object();
+    _to_json(node);
+    std::vector< BinaryModelNode > nodes;
+    flatten(node, nodes);
+    unsigned int const count = nodes.size();
+    buffer.append((char const *)(& count), sizeof(unsigned int));
+    buffer.append((char const *)(nodes.data()), nodes.size() * sizeof(BinaryModelNode));
+}
+
+void Model::save_binary(std::string const & path, std::string const & buffer, unsigned int model_count) {
+    ModelFileHeader header;
+    memcpy(header.magic, model_magic, sizeof(model_magic));
+    header.version = model_version;
+    header.node_bytes = sizeof(BinaryModelNode);
+    header.model_count = model_count;
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output.good()) {
+        throw IntegrityViolation("Model::save_binary", "Failed to open binary model file: " + path);
+    }
+    output.write((char const *)(& header), sizeof(ModelFileHeader));
+    output.write(buffer.data(), buffer.size());
+}
+
+bool BinaryModelReader::load(std::string const & path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.good()) { return false; }
+
+    ModelFileHeader header;
+    input.read((char *)(& header), sizeof(ModelFileHeader));
+    if (!input.good()
+        || memcmp(header.magic, model_magic, sizeof(model_magic)) != 0
+        || header.version != model_version
+        || header.node_bytes != sizeof(BinaryModelNode)) { return false; }
+
+    this -> buffer.clear();
+    this -> counts.clear();
+    this -> offsets.clear();
+    for (unsigned int model = 0; model < header.model_count; ++model) {
+        unsigned int count;
+        input.read((char *)(& count), sizeof(unsigned int));
+        if (!input.good() || count == 0) { return false; }
+        size_t const offset = this -> buffer.size();
+        this -> buffer.resize(offset + (size_t)(count) * sizeof(BinaryModelNode));
+        input.read(& this -> buffer[offset], (size_t)(count) * sizeof(BinaryModelNode));
+        if (!input.good()) { return false; }
+        this -> counts.push_back(count);
+        this -> offsets.push_back(offset);
+    }
+    return true;
+}
+
+unsigned int BinaryModelReader::models(void) const { return this -> counts.size(); }
+
+unsigned int BinaryModelReader::nodes(unsigned int model) const { return this -> counts[model]; }
+
+BinaryModelNode const * BinaryModelReader::read(unsigned int model) const {
+    return (BinaryModelNode const *)(this -> buffer.data() + this -> offsets[model]);
+}
+
+unsigned int BinaryModelReader::predict(unsigned int model, Bitmask const & sample) const {
+    BinaryModelNode const * records = read(model);
+    unsigned int index = 0;
+    while (records[index].negative != 0) {
+        index = sample.get(records[index].feature) ? records[index].positive : records[index].negative;
+    }
+    return records[index].feature;
+}
+
 void Model::intersect(json & src, json & dest) const {
 
     if (!src[0].is_null() && !dest[0].is_null()) {
@@ -241,14 +357,14 @@ void Model::to_json(json & node) const {
     _to_json(node);
     decode_json(node);
     // Convert to N-ary
-    if (Configuration::non_binary) { summarize(node); }
+    if (Configuration::non_binary()) { summarize(node); }
 }
 
 void Model::_to_json(json & node) const {
     if (this -> terminal) {
         node["prediction"] = this -> binary_target;
         node["loss"] = this -> _loss; // This value is correct regardless of translation
-        node["complexity"] = Configuration::regularization;
+        node["complexity"] = this -> _complexity; // The regularization in effect when this model was extracted
     } else {
         node["feature"] = this -> binary_feature;
         node["false"] = json::object();
@@ -256,11 +372,17 @@ void Model::_to_json(json & node) const {
         this -> negative -> _to_json(node["false"]);
         this -> positive -> _to_json(node["true"]);
 
-        if (this -> negative_translator.size() > 0) {
-            translate_json(node["false"],  this -> negative -> self_translator, this -> negative_translator);
+        // Null translators denote the identity, under which no node needs rewriting
+        static translation_type const identity = translation_type();
+        if (this -> negative_translator) {
+            translate_json(node["false"],
+                this -> negative -> self_translator ? * (this -> negative -> self_translator) : identity,
+                * (this -> negative_translator));
         }
-        if (this -> positive_translator.size() > 0) {
-            translate_json(node["true"],  this -> positive -> self_translator, this -> positive_translator);
+        if (this -> positive_translator) {
+            translate_json(node["true"],
+                this -> positive -> self_translator ? * (this -> positive -> self_translator) : identity,
+                * (this -> positive_translator));
         }
     }
     return;
@@ -269,9 +391,9 @@ void Model::_to_json(json & node) const {
 void Model::translate_json(json & node, translation_type const & main, translation_type const & alternative) const {
     if (node.contains("prediction")) {
         // index translation to undo any reordering from tile normalization
-        int cannonical_index = (int)(node["prediction"]) + State::dataset.width();
+        int cannonical_index = (int)(node["prediction"]) + State::dataset().width();
         int normal_index = std::distance(main.begin(), std::find(main.begin(), main.end(), cannonical_index));
-        int alternative_index = (int)(alternative.at(normal_index)) - State::dataset.width();
+        int alternative_index = (int)(alternative.at(normal_index)) - State::dataset().width();
 
         node["prediction"] = alternative_index;
     } else if (node.contains("feature")) {
@@ -305,8 +427,8 @@ void Model::translate_json(json & node, translation_type const & main, translati
 void Model::decode_json(json & node) const {
     if (node.contains("prediction")) {
         std::string prediction_name, prediction_value;
-        State::dataset.encoder.target_value(node["prediction"], prediction_value);
-        State::dataset.encoder.header(prediction_name);
+        State::dataset().encoder.target_value(node["prediction"], prediction_value);
+        State::dataset().encoder.header(prediction_name);
 
         if (Encoder::test_integral(prediction_value)) {
             node["prediction"] = atoi(prediction_value.c_str());
@@ -321,9 +443,9 @@ void Model::decode_json(json & node) const {
         unsigned int binary_feature_index = node["feature"];
         unsigned int feature_index;
         std::string feature_name, feature_type, relation, reference;
-        State::dataset.encoder.decode(binary_feature_index, & feature_index);
-        State::dataset.encoder.encoding(binary_feature_index, feature_type, relation, reference);
-        State::dataset.encoder.header(feature_index, feature_name);
+        State::dataset().encoder.decode(binary_feature_index, & feature_index);
+        State::dataset().encoder.encoding(binary_feature_index, feature_type, relation, reference);
+        State::dataset().encoder.header(feature_index, feature_name);
 
         node["feature"] = feature_index;
         node["name"] = feature_name;
@@ -20,6 +20,47 @@
 
 using json = nlohmann::json;
 
+// One node of a binary-serialized model, in encoded feature space; records are laid out in
+// preorder with children addressed by node index, so node 0 is always the root and a child
+// index of 0 unambiguously marks a leaf
+struct BinaryModelNode {
+    unsigned int feature; // Splits: binary feature index into the encoder schema; leaves: target value index
+    unsigned int negative; // Node index of the subtree where the test fails, 0 for leaves
+    unsigned int positive; // Node index of the subtree where the test passes, 0 for leaves
+    float loss; // Training loss incurred by a leaf, 0 for splits
+    float complexity; // Complexity penalty incurred by a leaf, 0 for splits
+};
+
+// Read-only view over a binary model file written by Model::save_binary, so a scorer can
+// predict without parsing JSON; feature and prediction indices resolve against the encoder
+// schema of the dataset the models were trained on
+class BinaryModelReader {
+public:
+    // @param path: the binary model file to load
+    // @returns false when the file is missing, from a different version or layout, or truncated
+    bool load(std::string const & path);
+
+    // @returns the number of models in the loaded file
+    unsigned int models(void) const;
+
+    // @param model: index of the queried model
+    // @returns the number of nodes in the queried model
+    unsigned int nodes(unsigned int model) const;
+
+    // @param model: index of the queried model
+    // @returns the queried model's node records, in preorder
+    BinaryModelNode const * read(unsigned int model) const;
+
+    // @param model: index of the model to predict with
+    // @param sample: bitmask of encoded binary features
+    // @returns the index of the predicted target value
+    unsigned int predict(unsigned int model, Bitmask const & sample) const;
+private:
+    std::string buffer; // Raw node records of every model, in file order
+    std::vector< unsigned int > counts; // Node count per model
+    std::vector< size_t > offsets; // Byte offset of each model's first record within buffer
+};
+
 // Container for holding classification model extracted from the dependency graph
 class Model {
 public:    
@@ -42,9 +83,11 @@ public:
     void identify(key_type const & indentifier);
     bool identified(void);
 
-    void translate_self(translation_type const & translation);
-    void translate_negatives(translation_type const & translation);
-    void translate_positives(translation_type const & translation);
+    // Attach interned translations by shared handle; a null handle denotes the identity,
+    // under which serialization skips translation entirely
+    void translate_self(shared_translation const & translation);
+    void translate_negatives(shared_translation const & translation);
+    void translate_positives(shared_translation const & translation);
 
     // Equality operator implemented by comparing the set of addresses of the bitmask of each leaf
     // @param other: other model to compare against
@@ -77,6 +120,18 @@ public:
     // @modifies serialization: string representation of the JSON object representation of this model
     void serialize(std::string & serialization, int const spacing = 0) const;
 
+    // @modifies buffer: appends this model's node count followed by its BinaryModelNode
+    //           records in preorder, ready for save_binary
+    // @note translations from tile canonicalization are undone through the same machinery
+    //       as to_json, so the binary and JSON outputs always describe the same tree
+    void to_binary(std::string & buffer) const;
+
+    // @param path: file to store the binary model set in
+    // @param buffer: concatenation of models previously appended by to_binary
+    // @param model_count: the number of models appended to buffer
+    // @modifies writes a versioned header followed by buffer (see model.cpp for the layout)
+    static void save_binary(std::string const & path, std::string const & buffer, unsigned int model_count);
+
     key_type identifier; // Identifier for association to graph vertex
 
     bool terminal = false; // Flag specifying whether the node is terminal
@@ -97,9 +152,9 @@ private:
     std::string reference; // reference value to compare with the decoded feature
     std::shared_ptr<Model> negative; // left subtree
     std::shared_ptr<Model> positive; // right subtree
-    translation_type self_translator; // self feature reordering
-    translation_type negative_translator; // left subtree feature reordering
-    translation_type positive_translator; // right subtree feature reordering
+    shared_translation self_translator; // self feature reordering, shared with the interning pool
+    shared_translation negative_translator; // left subtree feature reordering
+    shared_translation positive_translator; // right subtree feature reordering
 
     // Terminal members
     std::string prediction; // string representation of the predicted value
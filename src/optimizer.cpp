@@ -2,6 +2,7 @@
 
 #include "optimizer/diagnosis/false_convergence.hpp"
 #include "optimizer/diagnosis/non_convergence.hpp"
+#include "optimizer/diagnosis/sampling.hpp"
 #include "optimizer/diagnosis/trace.hpp"
 #include "optimizer/diagnosis/tree.hpp"
 #include "optimizer/dispatch/dispatch.hpp"
@@ -12,38 +13,212 @@ Optimizer::Optimizer(void) {
 }
 
 Optimizer::~Optimizer(void) {
-    State::reset();
+    State::reset(this -> retain_dataset);
     return;
 }
 
 
 
-void Optimizer::load(std::istream & data_source) { State::initialize(data_source, Configuration::worker_limit); }
+void Optimizer::load(std::istream & data_source) { State::initialize(data_source, Configuration::worker_limit()); }
+
+void Optimizer::load(unsigned char const * matrix, unsigned int samples, unsigned int columns) { State::initialize(matrix, samples, columns, Configuration::worker_limit()); }
+
+void Optimizer::load(void) { State::initialize(Configuration::worker_limit()); }
 
 void Optimizer::reset(void) { State::reset(); }
 
 void Optimizer::initialize(void) {
-    // Initialize Profile Output
-    if (Configuration::profile != "") {
-        std::ofstream profile_output(Configuration::profile);
-        profile_output << "iterations,time,lowerbound,upperbound,graph_size,queue_size,explore,exploit";
-        profile_output << std::endl;
-        profile_output.flush();
+    // Truncate Profile Output; each sample is appended as one JSON line
+    if (Configuration::profile() != "") {
+        std::ofstream profile_output(Configuration::profile());
     }
 
     // Initialize Timing State
     this -> start_time = tbb::tick_count::now();
+    this -> checkpoint_time = this -> start_time;
 
-    int const n = State::dataset.height();
-    int const m = State::dataset.width();
+    int const n = State::dataset().height();
+    int const m = State::dataset().width();
 
     // Enqueue for exploration
-    State::locals[0].outbound_message.exploration(Tile(), Bitmask(n, true, NULL, Configuration::depth_budget), Bitmask(m, true), 0, std::numeric_limits<float>::max());
-    State::queue.push(State::locals[0].outbound_message);
+    State::locals()[0].outbound_message.exploration(Tile(), Bitmask(n, true, NULL, Configuration::depth_budget()), Bitmask(m, true), 0, std::numeric_limits<float>::max());
+    State::queue().push(std::move(State::locals()[0].outbound_message));
     return;
 }
 
 
+void Optimizer::refresh(float previous_regularization) {
+    // Vertices pruned into leaves lost their feature sets under the previous regularization
+    // and cannot be re-split, so drop them and let the next solve recreate them
+    std::vector< key_type > pruned;
+    for (vertex_table::iterator iterator = State::graph().vertices.begin(); iterator != State::graph().vertices.end(); ++iterator) {
+        if (iterator -> second.feature_set().empty()) {
+            pruned.emplace_back(iterator -> first);
+        } else {
+            iterator -> second.reseed(previous_regularization, Configuration::regularization());
+        }
+    }
+    for (auto iterator = pruned.begin(); iterator != pruned.end(); ++iterator) { State::graph().vertices.erase(* iterator); }
+
+    // Split bounds, edge scopes and child links were derived under the previous
+    // regularization; dispatch rebuilds them as the retained vertices are revisited
+    State::graph().bounds.clear();
+    State::graph().edges.clear();
+    State::graph().children.clear();
+    State::graph().translations.clear();
+    State::queue() = Queue();
+
+    this -> global_lowerbound = -std::numeric_limits<float>::max();
+    this -> global_upperbound = std::numeric_limits<float>::max();
+    this -> global_boundary = std::numeric_limits<float>::max();
+    this -> active = true;
+    this -> ticks = 0;
+    this -> exhausted = false;
+    State::pressure() = false;
+}
+
+void Optimizer::checkpoint(void) {
+    json snapshot = json::object();
+    snapshot["regularization"] = Configuration::regularization();
+    snapshot["height"] = State::dataset().height();
+    snapshot["width"] = State::dataset().width();
+    snapshot["weight"] = State::dataset().total_weight(); // Lets a later solve on appended rows scale this bound
+    snapshot["samples"] = State::dataset().size();
+    snapshot["lowerbound"] = this -> global_lowerbound;
+    snapshot["upperbound"] = this -> global_upperbound;
+    json vertices = json::array();
+    // Workers keep inserting while the snapshot is taken, and the vertex table does not
+    // support traversal concurrent with insertion; enumerate the interned identifier vector
+    // instead, which only grows, and resolve each identifier with an ordinary look-up.
+    // A subproblem recreated after collection appears under two indices, but restore keys
+    // insertions by identifier, so the duplicate record is simply ignored
+    unsigned int const interned = State::graph().interned_count();
+    for (unsigned int index = 0; index < interned; ++index) {
+        const_vertex_accessor entry;
+        if (!State::graph().vertices.find(entry, State::graph().identifier(index))) { continue; } // Reclaimed
+        Task const & task = entry -> second;
+        json vertex = json::object();
+        vertex["capture"] = task.capture_set().to_string();
+        vertex["depth"] = (unsigned int)(task.capture_set().get_depth_budget());
+        vertex["features"] = task.feature_set().to_string();
+        vertex["lowerbound"] = task.lowerbound();
+        vertex["upperbound"] = task.upperbound();
+        vertices.push_back(vertex);
+    }
+    snapshot["vertices"] = vertices;
+    std::string staging = Configuration::checkpoint() + ".partial";
+    std::ofstream snapshot_output(staging, std::ios_base::trunc);
+    snapshot_output << snapshot.dump();
+    snapshot_output.close();
+    std::rename(staging.c_str(), Configuration::checkpoint().c_str());
+}
+
+bool Optimizer::restore(void) {
+    std::ifstream snapshot_input(Configuration::checkpoint());
+    if (!snapshot_input.good()) { return false; }
+    json snapshot;
+    snapshot_input >> snapshot;
+
+    unsigned int const n = State::dataset().height();
+    unsigned int const m = State::dataset().width();
+    if (std::abs(snapshot["regularization"].get<float>() - Configuration::regularization()) > std::numeric_limits<float>::epsilon()) {
+        std::cout << "Checkpoint does not match the loaded dataset and configuration. Ignoring: " << Configuration::checkpoint() << std::endl;
+        return false;
+    }
+    if (snapshot["height"].get<unsigned int>() != n || snapshot["width"].get<unsigned int>() != m) {
+        // The vertex capture masks are expressed over equivalence classes, whose identities
+        // shift as soon as rows are appended, so the graph itself cannot be transferred to a
+        // grown dataset. The root objective bound can: the previous optimum misclassifies at
+        // worst every appended row, so its rescaled objective plus slack for the new weight
+        // still upperbounds the new optimum, which prunes like the upperbound option
+        if (snapshot["width"].get<unsigned int>() == m && snapshot.contains("weight")) {
+            float const old_total = snapshot["weight"].get<float>();
+            float const new_total = State::dataset().total_weight();
+            if (old_total < new_total) {
+                float const scale = old_total / new_total;
+                float const slack = (new_total - old_total) / new_total;
+                // The complexity term does not rescale with the loss, which costs at most one
+                // more unit of slack since a tree's objective never exceeds one
+                this -> restored_upperbound = std::min((float)(1.0), snapshot["upperbound"].get<float>() * scale + 2 * slack);
+                std::cout << "Checkpoint predates appended rows. Warm starting the upperbound at "
+                    << this -> restored_upperbound << " from: " << Configuration::checkpoint() << std::endl;
+            }
+        }
+        if (this -> restored_upperbound == std::numeric_limits<float>::max()) {
+            std::cout << "Checkpoint does not match the loaded dataset and configuration. Ignoring: " << Configuration::checkpoint() << std::endl;
+        }
+        return false;
+    }
+
+    for (auto iterator = snapshot["vertices"].begin(); iterator != snapshot["vertices"].end(); ++iterator) {
+        json const & vertex = * iterator;
+        std::string const & capture_string = vertex["capture"].get_ref<std::string const &>();
+        std::string const & feature_string = vertex["features"].get_ref<std::string const &>();
+        Bitmask capture_set(n, false, NULL, (unsigned char)(vertex["depth"].get<unsigned int>()));
+        for (unsigned int i = 0; i < n; ++i) { if (capture_string[i] == '1') { capture_set.set(i, true); } }
+        Bitmask feature_set(m, false);
+        for (unsigned int j = 0; j < m; ++j) { if (feature_string[j] == '1') { feature_set.set(j, true); } }
+
+        // Rebuild the vertex from its problem definition and tighten its upperbound. The
+        // lowerbound is deliberately left at its recomputed value: restoring it would mark
+        // the vertex converged and stop it from re-exploring the children, edges and split
+        // bounds that model extraction walks, which are not part of the snapshot
+        Task task(capture_set, feature_set, 0);
+        task.update(task.lowerbound(), vertex["upperbound"].get<float>(), -1);
+        State::dataset().tile(task.capture_set(), task.feature_set(), task.identifier(), task.order(), 0);
+        vertex_accessor stored;
+        if (State::graph().vertices.insert(stored, std::make_pair(task.identifier(), task))) {
+            stored -> second.vertex_index() = State::graph().intern(stored -> first);
+        }
+    }
+
+    this -> global_upperbound = snapshot["upperbound"].get<float>();
+    return true;
+}
+
+void Optimizer::exchange_bound(unsigned int id) {
+    float const epsilon = std::numeric_limits<float>::epsilon();
+    float foreign = std::numeric_limits<float>::max();
+    {
+        std::ifstream channel_input(Configuration::bound_channel());
+        if (channel_input.good()) {
+            json shared;
+            try {
+                channel_input >> shared;
+                // A bound is only transferable between processes solving the same instance,
+                // so a file left over from another dataset or regularization is ignored
+                if (shared["height"].get<unsigned int>() == State::dataset().height()
+                    && shared["width"].get<unsigned int>() == State::dataset().width()
+                    && std::abs(shared["regularization"].get<float>() - Configuration::regularization()) <= std::numeric_limits<float>::epsilon()) {
+                    foreign = shared["upperbound"].get<float>();
+                }
+            } catch (...) { foreign = std::numeric_limits<float>::max(); } // A torn file is ignored
+        }
+    }
+    if (foreign < this -> global_upperbound - epsilon) {
+        // Another process holds a better bound; clamp the root vertex so the foreign bound
+        // prunes exactly like the upperbound option, and fold it into the global boundary,
+        // which schedules a tightening sweep when the drop is large
+        vertex_accessor root_vertex;
+        if (State::graph().vertices.find(root_vertex, this -> root)) {
+            Task & task = root_vertex -> second;
+            task.update(task.lowerbound(), std::min(task.upperbound(), foreign), -1);
+            update_root(task.lowerbound(), task.upperbound(), id);
+        }
+    } else if (this -> global_upperbound < foreign - epsilon && this -> global_upperbound < std::numeric_limits<float>::max()) {
+        json shared = json::object();
+        shared["height"] = State::dataset().height();
+        shared["width"] = State::dataset().width();
+        shared["regularization"] = Configuration::regularization();
+        shared["upperbound"] = this -> global_upperbound;
+        std::string staging = Configuration::bound_channel() + ".partial";
+        std::ofstream channel_output(staging, std::ios_base::trunc);
+        channel_output << shared.dump();
+        channel_output.close();
+        std::rename(staging.c_str(), Configuration::bound_channel().c_str());
+    }
+}
+
 void Optimizer::objective_boundary(float * lowerbound, float * upperbound) const {
     * lowerbound = this -> global_lowerbound;
     * upperbound = this -> global_upperbound;
@@ -62,7 +237,11 @@ float Optimizer::elapsed(void) const {
 }
 
 bool Optimizer::timeout(void) const {
-    return (Configuration::time_limit > 0 && elapsed() > Configuration::time_limit);
+    return (Configuration::time_limit() > 0 && elapsed() > Configuration::time_limit());
+}
+
+bool Optimizer::out_of_memory(void) const {
+    return this -> exhausted;
 }
 
 bool Optimizer::complete(void) const {
@@ -70,17 +249,46 @@ bool Optimizer::complete(void) const {
 }
 
 unsigned int Optimizer::size(void) const {
-    return State::graph.size();
+    return State::graph().size();
 }
 
 bool Optimizer::iterate(unsigned int id) {
     bool update = false;
-    if (State::queue.pop(State::locals[id].inbound_message)) {
-        update = dispatch(State::locals[id].inbound_message, id);
-        switch (State::locals[id].inbound_message.code) {
-            case Message::exploration_message: { this -> explore += 1; break; }
-            case Message::exploitation_message: { this -> exploit += 1; break; }
+    LocalState & local = State::locals()[id];
+    // Drain a batch per queue visit so the synchronization and membership maintenance paid
+    // per pop amortizes over many dispatches
+    unsigned int const extracted = State::queue().pop_batch(local.inbound_batch, Queue::batch_limit);
+    if (extracted > 0) {
+        // Process the batch grouped by recipient hash, so messages to the same vertex run
+        // back-to-back against warm vertex-table buckets; the batch is small, so the
+        // deviation from priority order is bounded
+        unsigned int ranks[Queue::batch_limit];
+        size_t digests[Queue::batch_limit]; // Hashes scan the full identifier, so compute each once
+        for (unsigned int i = 0; i < extracted; ++i) { ranks[i] = i; digests[i] = local.inbound_batch[i].hash(); }
+        std::sort(ranks, ranks + extracted, [&digests](unsigned int left, unsigned int right) {
+            return digests[left] < digests[right];
+        });
+        for (unsigned int i = 0; i < extracted; ++i) {
+            Message const & message = local.inbound_batch[ranks[i]];
+            bool dispatched = dispatch(message, id);
+            update = update || dispatched;
+            local.tally_iterations += 1;
+            switch (message.code) {
+                case Message::exploration_message: { local.tally_explore += 1; break; }
+                case Message::exploitation_message: { local.tally_exploit += 1; break; }
+            }
+            if (Configuration::diagnostics()) {
+                // Exploitations address their recipient vertex directly; explorations only
+                // name their sender, whose child tile is canonicalized during dispatch
+                bool const exploring = message.code == Message::exploration_message;
+                local.record_dispatch(message.code, exploring ? message.feature : 0, message.scope,
+                    exploring ? message.sender_tile : message.recipient_tile);
+            }
         }
+    } else if (id != 0 && this -> active) {
+        // Park instead of spinning on an empty queue; worker 0 keeps polling because it
+        // manages ticks, timeouts and the termination flag
+        State::queue().park();
     }
 
     // Worker 0 is responsible for managing ticks and snapshots
@@ -88,13 +296,48 @@ bool Optimizer::iterate(unsigned int id) {
         this -> ticks += 1;
 
         // snapshots that would need to occur every iteration
-        // if (Configuration::trace != "") { this -> diagnostic_trace(this -> ticks, State::locals[id].message); }
-        if (Configuration::tree != "") { this -> diagnostic_tree(this -> ticks); }
+        // if (Configuration::trace() != "") { this -> diagnostic_trace(this -> ticks, State::locals()[id].message); }
+        if (Configuration::tree() != "") { this -> diagnostic_tree(this -> ticks); }
 
         // snapshots that can skip unimportant iterations
-        if (update || complete() || ((this -> ticks) % (this -> tick_duration)) == 0) { // Periodic check for completion for timeout
+        // Checking the deadline every visit costs one clock read per batch, and keeps short
+        // time boxes (autotune probes in particular) from overshooting by whole tick periods
+        if (update || complete() || timeout() || ((this -> ticks) % (this -> tick_duration)) == 0) { // Periodic check for completion for timeout
             // Update the continuation flag for all threads
-            this -> active = !complete() && !timeout() && (Configuration::worker_limit > 1 || State::queue.size() > 0);
+            this -> active = !complete() && !timeout() && (Configuration::worker_limit() > 1 || State::queue().size() > 0);
+            if (!(this -> active)) { Queue::awaken(); } // Release parked workers so they observe termination
+            if (Configuration::memory_limit() > 0) {
+                unsigned int const limit = Configuration::memory_limit();
+                unsigned int const usage = Graph::memory_usage();
+                if (usage * 10 > limit * 9) { // Within 10% of the budget
+                    State::graph().collect(); // Reclaim vertices condemned as dominated since the last pass
+                    State::pressure() = true; // Degrade to depth-prioritized exploration to bound frontier growth
+                    if (Graph::memory_usage() > limit) {
+                        // Collection could not bring usage back under the budget; stop the
+                        // search and let extraction report the best model with its gap
+                        this -> exhausted = true;
+                        this -> active = false;
+                        Queue::awaken();
+                    }
+                } else if (State::pressure() && usage * 4 < limit * 3) {
+                    State::pressure() = false; // Enough headroom reclaimed to resume best-first order
+                }
+            }
+            if (Configuration::bound_channel() != "") {
+                exchange_bound(id); // Adopt or publish the bound shared with cooperating processes
+            }
+            if (this -> tightening_stale) {
+                this -> tightening_stale = false;
+                tighten_graph(id); // Convert the root improvement into immediate graph-wide pruning
+            }
+            if (Configuration::checkpoint() != "" && (tbb::tick_count::now() - this -> checkpoint_time).seconds() > Configuration::checkpoint_interval()) {
+                this -> checkpoint_time = tbb::tick_count::now();
+                checkpoint();
+            }
+            if (Configuration::anytime() && this -> incumbent_stale) {
+                this -> incumbent_stale = false;
+                incumbent();
+            }
             this -> print();
             this -> profile();
         }
@@ -103,44 +346,72 @@ bool Optimizer::iterate(unsigned int id) {
 }
 
 void Optimizer::print(void) const {
-    if (Configuration::verbose) { // print progress to standard output
+    if (Configuration::verbose()) { // print progress to standard output
         float lowerbound, upperbound;
         objective_boundary(& lowerbound, & upperbound);
         std::cout <<
             "Time: " << elapsed() <<
             ", Objective: [" << lowerbound << ", " << upperbound << "]" <<
             ", Boundary: " << this -> global_boundary <<
-            ", Graph Size: " << State::graph.size() <<
-            ", Queue Size: " << State::queue.size() << std::endl;
+            ", Graph Size: " << State::graph().size() <<
+            ", Queue Size: " << State::queue().size() << std::endl;
     }
 }
 
 void Optimizer::profile(void) {
-    if (Configuration::profile != "") {
-        std::ofstream profile_output(Configuration::profile, std::ios_base::app);
-        float lowerbound, upperbound;
-        objective_boundary(& lowerbound, & upperbound);
-        profile_output << this -> ticks << "," << elapsed() << "," <<
-            lowerbound << "," << upperbound << "," << State::graph.size() << "," << 
-            State::queue.size() << "," << this -> explore << "," << this -> exploit;
-        profile_output << std::endl;
-        profile_output.flush();
-        this -> explore = 0;
-        this -> exploit = 0;
+    if (Configuration::profile() == "") { return; }
+    float lowerbound, upperbound;
+    objective_boundary(& lowerbound, & upperbound);
+
+    // Aggregate the cumulative per-worker tallies; each worker owns its own entry, so the
+    // reads are unsynchronized and a sample may be slightly stale, never torn per counter
+    json sample = json::object();
+    sample["stage"] = "search";
+    sample["time"] = elapsed();
+    sample["ticks"] = this -> ticks;
+    sample["lowerbound"] = lowerbound;
+    sample["upperbound"] = upperbound;
+    sample["graph_size"] = State::graph().size();
+    sample["queue_size"] = State::queue().size();
+    unsigned long long iterations = 0, explore = 0, exploit = 0;
+    unsigned long long vertex_hits = 0, vertex_misses = 0, bound_updates = 0, summaries = 0;
+    json workers = json::array();
+    for (auto iterator = State::locals().begin(); iterator != State::locals().end(); ++iterator) {
+        iterations += iterator -> tally_iterations;
+        explore += iterator -> tally_explore;
+        exploit += iterator -> tally_exploit;
+        vertex_hits += iterator -> tally_vertex_hits;
+        vertex_misses += iterator -> tally_vertex_misses;
+        bound_updates += iterator -> tally_bound_updates;
+        summaries += iterator -> tally_summaries;
+        workers.push_back(iterator -> tally_iterations); // Per-worker utilization
     }
+    sample["iterations"] = iterations;
+    sample["explore"] = explore;
+    sample["exploit"] = exploit;
+    sample["vertex_hits"] = vertex_hits;
+    sample["vertex_misses"] = vertex_misses;
+    sample["bound_updates"] = bound_updates;
+    sample["summaries"] = summaries;
+    sample["workers"] = workers;
+
+    std::ofstream profile_output(Configuration::profile(), std::ios_base::app);
+    profile_output << sample.dump() << std::endl;
+    profile_output.flush();
 }
 
 float Optimizer::cart(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id) const {
-    Bitmask left(State::dataset.height());
-    Bitmask right(State::dataset.height());
+    Bitmask left(State::dataset().height());
+    Bitmask right(State::dataset().height());
     float potential, min_loss, guaranteed_min_loss, max_loss, base_info;
     unsigned int target_index;
-    State::dataset.summary(capture_set, base_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
-    float base_risk = max_loss + Configuration::regularization;
+    State::dataset().summary(capture_set, base_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+    float base_risk = max_loss + Configuration::regularization();
 
-    if (max_loss - min_loss < Configuration::regularization
-        || 1.0 - min_loss < Configuration::regularization
-        || (potential < 2 * Configuration::regularization && (1.0 - max_loss) < Configuration::regularization)
+    if (max_loss - min_loss < Configuration::regularization()
+        || 1.0 - min_loss < Configuration::regularization()
+        || (potential < 2 * Configuration::regularization() && (1.0 - max_loss) < Configuration::regularization())
+        || (Configuration::depth_budget() != 0 && capture_set.get_depth_budget() == 1) // depth budget exhausted, only a leaf fits
         || feature_set.empty()) {
         return base_risk;
     }
@@ -152,13 +423,13 @@ float Optimizer::cart(Bitmask const & capture_set, Bitmask const & feature_set,
             float left_info, right_info;
             left = capture_set;
             right = capture_set;
-            State::dataset.subset(j, false, left);
-            State::dataset.subset(j, true, right);
+            State::dataset().subset(j, false, left);
+            State::dataset().subset(j, true, right);
 
             if (left.empty() || right.empty()) { continue; }
 
-            State::dataset.summary(capture_set, left_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
-            State::dataset.summary(capture_set, right_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+            State::dataset().summary(left, left_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+            State::dataset().summary(right, right_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
 
             float gain = left_info + right_info - base_info;
             if (gain > information_gain) {
@@ -172,8 +443,69 @@ float Optimizer::cart(Bitmask const & capture_set, Bitmask const & feature_set,
 
     left = capture_set;
     right = capture_set;
-    State::dataset.subset(information_maximizer, false, left);
-    State::dataset.subset(information_maximizer, true, right);
+    State::dataset().subset(information_maximizer, false, left);
+    State::dataset().subset(information_maximizer, true, right);
     float risk = cart(left, feature_set, id) + cart(right, feature_set, id);
     return std::min(risk, base_risk);
 }
+
+float Optimizer::greedy_rule_list(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id) const {
+    Bitmask left(State::dataset().height());
+    Bitmask right(State::dataset().height());
+    float potential, min_loss, guaranteed_min_loss, max_loss, base_info;
+    unsigned int target_index;
+    State::dataset().summary(capture_set, base_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+    float base_risk = max_loss + Configuration::regularization();
+
+    if (max_loss - min_loss < Configuration::regularization()
+        || 1.0 - min_loss < Configuration::regularization()
+        || (potential < 2 * Configuration::regularization() && (1.0 - max_loss) < Configuration::regularization())
+        || (Configuration::depth_budget() != 0 && capture_set.get_depth_budget() == 1) // depth budget exhausted, only a leaf fits
+        || feature_set.empty()) {
+        return base_risk;
+    }
+
+    int information_maximizer = -1;
+    float information_gain = 0;
+    for (int j_begin = 0, j_end = 0; feature_set.scan_range(true, j_begin, j_end); j_begin = j_end) {
+        for (int j = j_begin; j < j_end; ++j) {
+            float left_info, right_info;
+            left = capture_set;
+            right = capture_set;
+            State::dataset().subset(j, false, left);
+            State::dataset().subset(j, true, right);
+
+            if (left.empty() || right.empty()) { continue; }
+
+            State::dataset().summary(left, left_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+            State::dataset().summary(right, right_info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+
+            float gain = left_info + right_info - base_info;
+            if (gain > information_gain) {
+                information_maximizer = j;
+                information_gain = gain;
+            }
+        }
+    }
+
+    if (information_maximizer == -1) { return base_risk; }
+
+    left = capture_set;
+    right = capture_set;
+    State::dataset().subset(information_maximizer, false, left);
+    State::dataset().subset(information_maximizer, true, right);
+
+    // Unlike cart, only one side may recurse; terminate the side with less to gain from
+    // further splitting as this rule's leaf and keep chaining down the other
+    float left_info, left_potential, left_min, left_guaranteed, left_max;
+    float right_info, right_potential, right_min, right_guaranteed, right_max;
+    State::dataset().summary(left, left_info, left_potential, left_min, left_guaranteed, left_max, target_index, id);
+    State::dataset().summary(right, right_info, right_potential, right_min, right_guaranteed, right_max, target_index, id);
+    float risk;
+    if (left_potential > right_potential) {
+        risk = greedy_rule_list(left, feature_set, id) + right_max + Configuration::regularization();
+    } else {
+        risk = left_max + Configuration::regularization() + greedy_rule_list(right, feature_set, id);
+    }
+    return std::min(risk, base_risk);
+}
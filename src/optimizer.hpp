@@ -1,19 +1,20 @@
 #ifndef OPTIMIZER_H
 #define OPTIMIZER_H
 
-// Invocation Priorities
-#define INFORMATION_PRIORITY 0
-#define CONSTRAINT_PRIORITY 0
-#define EXPLORATION_PRIORITY 0
-
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cmath>
+#include <cstdio>
 
 #include <queue>
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <unordered_map>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include <tbb/tick_count.h>
 #include <json/json.hpp>
 
@@ -26,6 +27,7 @@
 #include "types.hpp"
 #include "graph.hpp"
 #include "queue.hpp"
+#include "writer.hpp"
 #include "integrity_violation.hpp"
 
 using json = nlohmann::json;
@@ -35,11 +37,38 @@ public:
     Optimizer(void);
     ~Optimizer(void);
 
+    // When set, destruction keeps the loaded dataset in the active context while still
+    // releasing the search structures, so a resident process can fit the dataset again
+    bool retain_dataset = false;
+
     void load(std::istream & data_source);
+    void load(unsigned char const * matrix, unsigned int samples, unsigned int columns);
+
+    // @modifies resets the search structures while reusing the dataset already loaded into
+    //           the active context by an earlier fit
+    void load(void);
 
     void initialize(void);
     void reset(void);
 
+    // @param previous_regularization: the regularization used by the completed solve
+    // @modifies re-seeds the retained dependency graph for the next regularization in a sweep:
+    //           vertex bounds are relaxed so they remain valid, vertices that were pruned into
+    //           leaves under the previous regularization are dropped, and the derived tables
+    //           are cleared so dispatch rebuilds them on first visit
+    void refresh(float previous_regularization);
+
+    // @modifies writes a snapshot of the vertex table and root bounds to Configuration::checkpoint()
+    // @note the snapshot is written to a staging file and renamed, so an interrupted write never
+    //       replaces the previous checkpoint with a torn one
+    void checkpoint(void);
+
+    // @returns true if a checkpoint matching the loaded dataset and regularization was restored
+    // @note only vertices and their upperbounds are restored; the frontier, lowerbounds and the
+    //       derived tables are regenerated by re-exploring from the root, where the restored
+    //       upperbounds prune dominated branches as soon as they are revisited
+    bool restore(void);
+
     // @modifies lowerbound: the lowerbound on the global objective
     // @modifies upperbound: the upperbound on the global objective
     void objective_boundary(float * lowerbound, float * upperbound) const;
@@ -59,6 +88,10 @@ public:
     // @returns true if the configured time limit has been reached
     bool timeout(void) const;
 
+    // @returns true if the search was stopped because collection could not keep resident
+    //          memory under Configuration::memory_limit
+    bool out_of_memory(void) const;
+
     // @param id: ID of the requesting worker thread
     // @returns true if an update occured to the global objective boundary
     bool iterate(unsigned int id);
@@ -68,6 +101,20 @@ public:
     // @note: if the global optimality gap is non-zero, there is no gaurantee that results necessarily contains the optimal model
     void models(std::unordered_set< Model > & results);
 
+    // @param emit: callback invoked once per extracted model
+    // @modifies walks the dependency graph and emits each potentially optimal model one at a
+    //           time, keeping only the model currently being built in memory instead of
+    //           materializing the full model set
+    // @note rule lists filter candidates on per-model risk, which defeats rank enumeration,
+    //       so rule list extraction falls back to the materialized set
+    void models(std::function< void(Model &) > const & emit);
+
+    // @modifies writes the current best model and its optimality gap to Configuration::model(),
+    //           so an interrupted or timed-out run still yields the best tree found so far
+    // @note the snapshot is written to a staging file and renamed, so a run killed mid-write
+    //       never leaves a torn model file
+    void incumbent(void);
+
     // Generates snapshot data for trace visualization
     void diagnostic_trace(int iteration, key_type const & focal_point);
     // Generates snapshot data for trace-tree visualization
@@ -84,43 +131,111 @@ private:
 
     // Timing State
     tbb::tick_count start_time; // starting time of optimization
+    tbb::tick_count checkpoint_time; // time of the most recent checkpoint snapshot
     unsigned long ticks = 0; // Number of ticks passed
     unsigned long tick_duration = 10000; // Number of iterations per tick
     bool active = true; // Flag indicating whether the optimization is still active
 
     // Analytics State
     Tile root; // Root indicator
-    std::vector<int> translator; // Root indicator
+    shared_translation translator; // Root indicator
 
     float global_boundary = std::numeric_limits<float>::max(); // Global optimality gap
     float global_upperbound = std::numeric_limits<float>::max(); // Global upperbound of the objective
     float global_lowerbound = -std::numeric_limits<float>::max(); // Global lowerbound of the objective
     std::vector< unsigned int > work_distribution; // Distribution of work done for each percentile
-    unsigned int explore = 0.0; // Distributtion of work from downward message
-    unsigned int exploit = 0.0; // Distribution of work from upward message
+
+    // Set by any worker whose root update improves the global upperbound, cleared by the
+    // worker that writes the next incumbent snapshot; the race is benign since a missed
+    // set is rewritten on the next improvement
+    bool incumbent_stale = false;
+
+    // Set by any worker whose root update drops the global upperbound sharply, cleared by
+    // worker 0 before it runs the graph-wide tightening sweep; the race is benign since a
+    // missed set only delays the sweep until the next improvement
+    bool tightening_stale = false;
+
+    // Root upperbound carried over from a checkpoint of a smaller dataset, rescaled with
+    // slack for the appended rows; applied when the root vertex is created
+    float restored_upperbound = std::numeric_limits<float>::max();
+
+    // Set by worker 0 when the memory budget is exceeded even after a collection pass; the
+    // run then terminates and reports the best model found with its optimality gap
+    bool exhausted = false;
 
     float cart(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id) const;
 
+    // @param capture_set: the samples captured by the subproblem to warm start
+    // @param feature_set: the features available to the subproblem
+    // @param id: ID of the requesting worker thread
+    // @returns the objective of a greedy rule list built by information gain, recursing on
+    //          only one side of each split; used in place of cart for the rule-list warm
+    //          start, since a greedy tree's objective is not achievable by any rule list
+    float greedy_rule_list(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id) const;
+
     // @param message: message to handle
     // @param id: id of the worker thread that is handling this message
     // @returns true if the optimization is still active
     bool dispatch(Message const & message, unsigned int id);
 
-    bool store_self(Tile const & identifier, Task const & task, vertex_accessor & self);
+    // @param identifier: the vertex whose subtree models are counted
+    // @param counts: memo of counts per vertex, shared across one extraction
+    // @returns the number of potentially optimal models rooted at this vertex, saturated at
+    //          Configuration::model_limit() so counts never overflow
+    unsigned long long model_count(key_type const & identifier, std::unordered_map< key_type, unsigned long long > & counts);
+
+    // @param identifier: the vertex to extract a model from
+    // @param rank: which of the vertex's models to build, in a fixed enumeration order
+    // @param counts: memo of counts per vertex, fully populated by model_count on the root
+    // @returns the rank-th model rooted at this vertex, or null if rank is out of range
+    // @note read-only with respect to the graph and the memo, so extractions of distinct
+    //       ranks run safely in parallel
+    std::shared_ptr< Model > extract(key_type const & identifier, unsigned long long rank, std::unordered_map< key_type, unsigned long long > const & counts);
+
+    // @param identifier: the vertex to build the incumbent subtree for
+    // @returns the model following the lowest-upperbound derivation at each vertex, with a
+    //          leaf standing in wherever the search has not materialized a child yet
+    // @note read-only, so it runs safely while workers continue tightening the graph
+    std::shared_ptr< Model > incumbent_model(key_type const & identifier);
+
+    bool store_self(Tile const & identifier, Task const & task, vertex_accessor & self, unsigned int id);
 
     void store_children(Task & task, unsigned int id);
 
-    void link_to_parent(Tile const & parent, Bitmask const & features, Bitmask const & signs, float scope, Tile const & self, translation_type const & order, adjacency_accessor & parents);
+    void link_to_parent(Tile const & parent, Bitmask const & features, Bitmask const & signs, float scope, Tile const & self, unsigned int self_index, shared_translation const & order, adjacency_accessor & parents);
 
-    void signal_exploiters(adjacency_accessor & parents, Task & self, unsigned int id);
+    void signal_exploiters(adjacency_accessor & parents, Task const & self, unsigned int id);
 
-    bool load_children(Task & task, Bitmask const & features, unsigned int id);
+    bool load_children(Task const & task, Bitmask const & features, unsigned int id);
 
     bool load_parents(Tile const & identifier, adjacency_accessor & parents);
 
     bool load_self(Tile const & identifier, vertex_accessor & self);
-
-    bool update_root(float lower, float upper);
+    // Shared-accessor overload for paths that only read the vertex or tighten its bounds
+    // through the packed atomics, so they never hold the bucket lock exclusively
+    bool load_self(Tile const & identifier, const_vertex_accessor & self);
+
+    bool update_root(float lower, float upper, unsigned int id);
+
+    // @param id: ID of the worker thread running the exchange
+    // @modifies reads the shared bound file at Configuration::bound_channel(): a foreign
+    //           upperbound better than ours is adopted by clamping the root vertex, which
+    //           prunes like the upperbound option and triggers a tightening sweep when the
+    //           drop is large; otherwise our own upperbound is published when it improves
+    //           on the file's contents
+    // @note the file is replaced by staging and rename, so readers never observe a torn
+    //       write; racing publishers may briefly regress the file, which the process
+    //       holding the better bound repairs on its next exchange
+    void exchange_bound(unsigned int id);
+
+    // @param id: ID of the worker thread running the sweep
+    // @modifies re-derives every stored vertex's bounds from its children's current bounds in
+    //           one parallel pass, and condemns vertices dominated within every scope that
+    //           reaches them, instead of waiting for the improvements to diffuse through
+    //           exploitation messages one edge at a time
+    // @note triggered by update_root when the root upperbound drops by more than one
+    //       regularization unit, since such drops invalidate bounds across the whole graph
+    void tighten_graph(unsigned int id);
 
     // @param set: identifier for the root node from which to extract optimal models
     // @modifies results: internal set of extracted models
@@ -130,6 +245,19 @@ private:
     void profile(void);
 
     // Diagnostics
+
+    // Vertex count above which anomaly diagnosis reports only the bounded samples, since the
+    // exhaustive recursive dumps grow with the graph and become unusable beyond toy scale
+    static unsigned int const exhaustive_diagnosis_limit = 4096;
+
+    // @param reason: label for the anomaly that triggered the flush
+    // @modifies prints each worker's ring of recent dispatch events, then resolves its
+    //           reservoir of sampled vertex identifiers against the live graph and prints
+    //           the ones that remain unconverged
+    // @note output is bounded by the fixed per-worker ring and reservoir capacities, so the
+    //       flush stays cheap enough to leave Configuration::diagnostics enabled on
+    //       production runs and still capture rare stuck-convergence incidents
+    void flush_diagnostics(std::string const & reason);
     bool diagnose_non_convergence(key_type const & set);
     bool diagnose_false_convergence(key_type const & set);
     bool diagnostic_trace(key_type const & identifier, json & tracer, key_type const & focal_point);
@@ -1,18 +1,19 @@
 void Optimizer::diagnose_false_convergence(void) {
+    flush_diagnostics("false-convergence");
     // diagnose_false_convergence(this -> root_set);
     return;
 }
 bool Optimizer::diagnose_false_convergence(key_type const & key) {
-    if (Configuration::diagnostics == false) { return false; }
+    if (Configuration::diagnostics() == false) { return false; }
     std::unordered_set< Model * > results;
     models(key, results);
     if (results.size() > 0) { return false; }
 
-    // unsigned int m = State::dataset.width();
+    // unsigned int m = State::dataset().width();
 
     // float epsilon = std::numeric_limits<float>::epsilon();
     vertex_accessor task;
-    State::graph.vertices.find(task, key);
+    State::graph().vertices.find(task, key);
 
     std::cout
         << "Task(" << task -> second.capture_set().to_string() << ") is falsely convergent."
@@ -20,7 +21,7 @@ bool Optimizer::diagnose_false_convergence(key_type const & key) {
         << ", Base = " << task -> second.base_objective() << std::endl;
     
     bound_accessor bounds;
-    State::graph.bounds.find(bounds, task -> second.identifier());
+    State::graph().bounds.find(bounds, task -> second.identifier());
     for (bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
         int feature = std::get<0>(* iterator);
         bool ready;
@@ -28,8 +29,8 @@ bool Optimizer::diagnose_false_convergence(key_type const & key) {
         for (int sign = -1; sign <= 1; sign += 2) {
             vertex_accessor child;
             child_accessor key;
-            ready = ready && State::graph.children.find(key, std::make_pair(task -> second.identifier(), sign * (feature + 1)))
-                && State::graph.vertices.find(child, key -> second);
+            ready = ready && State::graph().children.find(key, std::make_pair(task -> second.identifier(), sign * (feature + 1)))
+                && State::graph().vertices.find(child, State::graph().identifier(key -> second));
             if (ready) {
                 lower += child -> second.lowerbound();
                 upper += child -> second.upperbound();
@@ -47,15 +48,15 @@ bool Optimizer::diagnose_false_convergence(key_type const & key) {
         {
             vertex_accessor child;
             child_accessor key;
-            if (State::graph.children.find(key, std::make_pair(task -> second.identifier(), (feature + 1)))) {
-                diagnose_false_convergence(key -> second);
+            if (State::graph().children.find(key, std::make_pair(task -> second.identifier(), (feature + 1)))) {
+                diagnose_false_convergence(State::graph().identifier(key -> second));
             }
         }
         {
             vertex_accessor child;
             child_accessor key;
-            if (State::graph.children.find(key, std::make_pair(task -> second.identifier(), -(feature + 1)))) {
-                diagnose_false_convergence(key -> second);
+            if (State::graph().children.find(key, std::make_pair(task -> second.identifier(), -(feature + 1)))) {
+                diagnose_false_convergence(State::graph().identifier(key -> second));
             }
         }
     }
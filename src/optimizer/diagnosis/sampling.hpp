@@ -0,0 +1,34 @@
+void Optimizer::flush_diagnostics(std::string const & reason) {
+    std::cout << "Sampled Diagnosis (" << reason << ")" << std::endl;
+    unsigned int live = 0, reclaimed = 0, unconverged = 0;
+    for (unsigned int id = 0; id < State::locals().size(); ++id) {
+        LocalState const & local = State::locals()[id];
+        unsigned long long const retained = std::min(
+            (unsigned long long) LocalState::event_ring_capacity, local.event_cursor);
+        std::cout << "Worker " << id << ": " << local.event_cursor << " dispatches recorded, last "
+            << retained << " retained" << std::endl;
+        for (unsigned long long i = 0; i < retained; ++i) {
+            // Replay oldest first; the cursor marks the next slot the ring would overwrite
+            DiagnosticEvent const & event = local.event_ring[(local.event_cursor - retained + i) % LocalState::event_ring_capacity];
+            std::cout << "  Dispatch " << event.sequence
+                << ", " << (event.code == Message::exploration_message ? "Exploration" : "Exploitation");
+            if (event.feature != 0) { std::cout << ", Feature: " << event.feature; }
+            std::cout << ", Scope: " << event.scope << std::endl;
+        }
+        for (unsigned int i = 0; i < local.snapshot_reservoir.size(); ++i) {
+            const_vertex_accessor vertex;
+            if (!State::graph().vertices.find(vertex, local.snapshot_reservoir[i])) { reclaimed += 1; continue; }
+            live += 1;
+            Task const & task = vertex -> second;
+            if (task.uncertainty() == 0 || task.lowerbound() >= task.upperscope()) { continue; }
+            unconverged += 1;
+            // Unconverged samples localize a stuck frontier without walking the graph; only
+            // compact scalar fields are printed so the flush stays readable at any scale
+            std::cout << "  Unconverged Sample: Support: " << task.support()
+                << ", Bounds: [" << task.lowerbound() << ", " << task.upperbound() << "]"
+                << ", Scopes: [" << task.lowerscope() << ", " << task.upperscope() << "]" << std::endl;
+        }
+    }
+    std::cout << "Sampled Vertices: " << (live + reclaimed) << " (" << live << " live, "
+        << reclaimed << " reclaimed, " << unconverged << " unconverged)" << std::endl;
+}
@@ -1,3 +1,15 @@
+namespace {
+    // @param address: memory expected to be read shortly
+    // @note compiles to a no-op where the builtin is unavailable
+    inline void prefetch_address(void const * address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void) address;
+#endif
+    }
+}
+
 bool Optimizer::dispatch(Message const & message, unsigned int id) {
     bool global_update = false;
     switch (message.code) {
@@ -11,32 +23,47 @@ bool Optimizer::dispatch(Message const & message, unsigned int id) {
             Task task(capture_set, feature_set, id); // A vertex to represent the problem
             task.scope(message.scope);
             task.create_children(id); // Populate the thread's local cache with child instances
-            if (Configuration::feature_exchange || Configuration::continuous_feature_exchange) { task.prune_features(id); } // Prune using a set of bounds
-            translation_type order;
-            State::dataset.tile(task.capture_set(), task.feature_set(), task.identifier(), task.order(), id);
-
+            if (Configuration::feature_exchange() || Configuration::continuous_feature_exchange()) { task.prune_features(id); } // Prune using a set of bounds
+            State::dataset().tile(task.capture_set(), task.feature_set(), task.identifier(), task.order(), id);
 
             vertex_accessor vertex;
-            bool inserted = store_self(task.identifier(), task, vertex);
+            bool inserted = store_self(task.identifier(), task, vertex, id);
+
+            // A vertex retained across a regularization sweep has unset scopes; adopt this
+            // visit's scope so child bounds and re-exploration use a valid budget
+            if (!inserted && vertex -> second.upperscope() == std::numeric_limits<float>::max()) {
+                vertex -> second.scope(message.scope);
+            }
 
             store_children(vertex -> second, id);
 
             if (is_root) { // Update the optimizer state
-                // float root_upperbound = this -> cart(vertex -> second.capture_set(), vertex -> second.feature_set(), id);
-                // std::cout << "Cart: " << root_upperbound << std::endl;
-                float root_upperbound = 1.0;
-                if (Configuration::upperbound > 0.0) { root_upperbound = std::min(root_upperbound, Configuration::upperbound); }
+                // Warm-start with the objective of a greedy model so the frontier is pruned
+                // against a tight upper bound from the first iteration onward; rule lists get
+                // a greedy chain, since a greedy tree's objective is unachievable in that space
+                float root_upperbound = Configuration::rule_list()
+                    ? std::min((float)(1.0), this -> greedy_rule_list(vertex -> second.capture_set(), vertex -> second.feature_set(), id))
+                    : std::min((float)(1.0), this -> cart(vertex -> second.capture_set(), vertex -> second.feature_set(), id));
+                if (Configuration::upperbound() > 0.0) { root_upperbound = std::min(root_upperbound, Configuration::upperbound()); }
+                // A bound carried over from a checkpoint of a smaller dataset is consumed on
+                // first use; it is scaled for this regularization only, so later sweep
+                // rounds must not reapply it
+                root_upperbound = std::min(root_upperbound, this -> restored_upperbound);
+                this -> restored_upperbound = std::numeric_limits<float>::max();
                 vertex -> second.update(vertex -> second.lowerbound(), root_upperbound, -1);
                 this -> root = vertex -> second.identifier();
                 this -> translator = vertex -> second.order();
-                global_update = update_root(vertex -> second.lowerbound(), vertex -> second.upperbound());
+                global_update = update_root(vertex -> second.lowerbound(), vertex -> second.upperbound(), id);
             } else { // Connect and signal parents
                 adjacency_accessor parents;
-                link_to_parent(parent, message.features, message.signs, message.scope, vertex -> second.identifier(), vertex -> second.order(), parents);
+                // The translation must be the arriving task's: when this visit merged into a
+                // vertex first reached from an equivalent subproblem, the stored order maps the
+                // canonical columns to that representative's indices, not to this parent's
+                link_to_parent(parent, message.features, message.signs, message.scope, vertex -> second.identifier(), vertex -> second.vertex_index(), task.order(), parents);
                 signal_exploiters(parents, vertex -> second, id);
             }
 
-            if (Configuration::reference_LB || message.scope >= vertex -> second.upperscope()) {
+            if (Configuration::reference_LB() || message.scope >= vertex -> second.upperscope()) {
                 vertex -> second.send_explorers(message.scope, id);
             }
 
@@ -44,18 +71,26 @@ bool Optimizer::dispatch(Message const & message, unsigned int id) {
         }
         case Message::exploitation_message: {
             Tile const & identifier = message.recipient_tile;
-            vertex_accessor vertex, left, right;
+            // Bound merges go through the packed atomics, so exploitation only needs a shared
+            // accessor and concurrent exploiters of a hot vertex no longer serialize on its
+            // bucket lock; exclusive accessors are reserved for structural changes
+            const_vertex_accessor vertex;
 
-            load_self(identifier, vertex);
+            if (!load_self(identifier, vertex)) { break; } // The vertex may have been reclaimed by a collection pass
 
-            if (vertex -> second.uncertainty() == 0 || (!Configuration::reference_LB && vertex -> second.lowerbound() >= vertex -> second.upperscope() - std::numeric_limits<float>::epsilon())) { break; }
+            if (vertex -> second.uncertainty() == 0) { break; }
+            if (!Configuration::reference_LB() && vertex -> second.lowerbound() >= vertex -> second.upperscope() - std::numeric_limits<float>::epsilon()) {
+                // Provably dominated within every scope that reaches it; mark it for reclamation
+                if (Configuration::memory_limit() > 0) { State::graph().condemn(identifier); }
+                break;
+            }
             bool update = load_children(vertex -> second, message.features, id);
 
             // if (!update) { break; } // XXX Please check if this check still applies 
 
             bool is_root = vertex -> second.capture_set().count() == vertex -> second.capture_set().size();
             if (is_root) { // Update the optimizer state
-                global_update = update_root(vertex -> second.lowerbound(),  vertex -> second.upperbound());
+                global_update = update_root(vertex -> second.lowerbound(),  vertex -> second.upperbound(), id);
             } else {
                 adjacency_accessor parents; // find backward look-up entry
                 load_parents(identifier, parents);
@@ -73,41 +108,62 @@ bool Optimizer::dispatch(Message const & message, unsigned int id) {
     return global_update;
 }
 
-bool Optimizer::load_children(Task & task, Bitmask const & signals, unsigned int id) {
+bool Optimizer::load_children(Task const & task, Bitmask const & signals, unsigned int id) {
     float lower = task.base_objective(), upper = task.base_objective();
     int optimal_feature = -1;
     bound_accessor bounds;
-    State::graph.bounds.find(bounds, task.identifier());
+    if (!State::graph().bounds.find(bounds, task.identifier())) { return false; } // Reclaimed by a collection pass
     for (bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
         int feature = std::get<0>(* iterator);
 
         if (signals.get(feature)) { // An update is pending
+            // The mask backing the next pending child key is touched ahead of time so its
+            // hash and comparison reads do not stall the look-up below
+            {
+                bound_iterator ahead = iterator;
+                ++ahead;
+                if (ahead != bounds -> second.end() && signals.get(std::get<0>(* ahead))) {
+                    if (std::get<3>(* ahead) != unindexed_vertex) { prefetch_address(State::graph().identifier(std::get<3>(* ahead)).content().data()); }
+                    if (std::get<4>(* ahead) != unindexed_vertex) { prefetch_address(State::graph().identifier(std::get<4>(* ahead)).content().data()); }
+                }
+            }
             bool ready = true;
+            float child_lower[2], child_upper[2], child_base[2];
             for (int k = 0; k < 2; ++k) {
-                vertex_accessor child;
-                child_accessor key;
-                ready = ready && State::graph.children.find(key, std::make_pair(task.identifier(), k ?  -(feature + 1) : (feature + 1)))
-                    && State::graph.vertices.find(child, key -> second);
+                // The child's interned index is cached in the bound entry on first use,
+                // flattening the dependent child-table + vertex-table chain into one vertex
+                // look-up; the bound accessor is exclusive, so the lazy write is safe
+                unsigned int & linked = k ? std::get<4>(* iterator) : std::get<3>(* iterator);
+                if (linked == unindexed_vertex) {
+                    child_accessor key;
+                    if (State::graph().children.find(key, std::make_pair(task.identifier(), k ?  -(feature + 1) : (feature + 1)))) {
+                        linked = key -> second;
+                    }
+                }
+                const_vertex_accessor child;
+                ready = ready && linked != unindexed_vertex && State::graph().vertices.find(child, State::graph().identifier(linked));
                 if (ready) {
-                    State::locals[id].neighbourhood[2 * feature + k] = child -> second;
+                    // Three scalar reads through a shared accessor replace copying the whole
+                    // child task under its bucket lock; the packed atomics make the pair
+                    // consistent, so readers of a hot child run concurrently
+                    child_lower[k] = child -> second.lowerbound();
+                    child_upper[k] = child -> second.upperbound();
+                    child_base[k] = child -> second.base_objective();
                 }
             }
 
             if (ready) {
                 float split_lower, split_upper;
-                Task const & left = State::locals[id].neighbourhood[2 * feature];
-                Task const & right = State::locals[id].neighbourhood[2 * feature + 1];
-
-                if (Configuration::rule_list) {
-                    float lower_negative = left.lowerbound() + right.base_objective();
-                    float lower_positive = left.base_objective() + right.lowerbound();
+                if (Configuration::rule_list()) {
+                    float lower_negative = child_lower[0] + child_base[1];
+                    float lower_positive = child_base[0] + child_lower[1];
                     split_lower = std::min(lower_negative, lower_positive);
-                    float upper_negative = left.upperbound() + right.base_objective();
-                    float upper_positive = left.base_objective() + right.upperbound();
+                    float upper_negative = child_upper[0] + child_base[1];
+                    float upper_positive = child_base[0] + child_upper[1];
                     split_upper = std::min(upper_negative, upper_positive);
                 } else {
-                    split_lower = left.lowerbound() + right.lowerbound();
-                    split_upper = left.upperbound() + right.upperbound();
+                    split_lower = child_lower[0] + child_lower[1];
+                    split_upper = child_upper[0] + child_upper[1];
                 }
 
                 std::get<1>(* iterator) = split_lower;
@@ -115,7 +171,7 @@ bool Optimizer::load_children(Task & task, Bitmask const & signals, unsigned int
             }
         }
 
-        if (Configuration::similar_support) {
+        if (Configuration::similar_support()) {
             if (iterator != bounds -> second.begin()) { // Comparison with previous feature
                 unsigned int i, j;
                 float j_lower, j_upper;
@@ -126,7 +182,7 @@ bool Optimizer::load_children(Task & task, Bitmask const & signals, unsigned int
                 j_upper = std::get<2>(*iterator);
                 ++iterator;
 
-                float distance = State::dataset.distance(task.capture_set(), i, j, id);
+                float distance = State::dataset().distance(task.capture_set(), i, j, id);
                 std::get<1>(* iterator) = std::max(std::get<1>(* iterator), j_lower - distance);
                 std::get<2>(* iterator) = std::min(std::get<2>(* iterator), j_upper + distance);
             }
@@ -142,7 +198,7 @@ bool Optimizer::load_children(Task & task, Bitmask const & signals, unsigned int
                     j_upper = std::get<2>(*iterator);
                     --iterator;
 
-                    float distance = State::dataset.distance(task.capture_set(), i, j, id);
+                    float distance = State::dataset().distance(task.capture_set(), i, j, id);
                     std::get<1>(* iterator) = std::max(std::get<1>(* iterator), j_lower - distance);
                     std::get<2>(* iterator) = std::min(std::get<2>(* iterator), j_upper + distance);
                 } else {
@@ -160,20 +216,31 @@ bool Optimizer::load_children(Task & task, Bitmask const & signals, unsigned int
 }
 
 bool Optimizer::load_parents(Tile const & identifier, adjacency_accessor & parents) {
-    return State::graph.edges.find(parents, identifier);
+    return State::graph().edges.find(parents, identifier);
 }
 
 bool Optimizer::load_self(Tile const & identifier, vertex_accessor & self) {
-    return State::graph.vertices.find(self, identifier);
+    return State::graph().vertices.find(self, identifier);
+}
+
+bool Optimizer::load_self(Tile const & identifier, const_vertex_accessor & self) {
+    return State::graph().vertices.find(self, identifier);
 }
 
-bool Optimizer::store_self(Tile const & identifier, Task const & value, vertex_accessor & self) {
-    return State::graph.vertices.insert(self, std::make_pair(identifier, value));
+bool Optimizer::store_self(Tile const & identifier, Task const & value, vertex_accessor & self, unsigned int id) {
+    bool inserted = State::graph().vertices.insert(self, std::make_pair(identifier, value));
+    if (inserted) {
+        // Interned under the exclusive accessor, so the index is visible to every reader
+        // that finds the vertex afterwards
+        self -> second.vertex_index() = State::graph().intern(identifier);
+        State::locals()[id].tally_vertex_misses += 1;
+    } else { State::locals()[id].tally_vertex_hits += 1; }
+    return inserted;
 }
 
 void Optimizer::store_children(Task & task, unsigned int id) {
     bound_accessor bounds;
-    bool inserted = State::graph.bounds.insert(bounds, task.identifier());
+    bool inserted = State::graph().bounds.insert(bounds, task.identifier());
     if (!inserted) { return; }
     int optimal_feature = -1;
     float lower = task.base_objective(), upper = task.base_objective();
@@ -181,21 +248,26 @@ void Optimizer::store_children(Task & task, unsigned int id) {
     for (int j_begin = 0, j_end = 0; features.scan_range(true, j_begin, j_end); j_begin = j_end) {
         for (int j = j_begin; j < j_end; ++j) {
 
-            if (Configuration::feature_transform == false) {
+            if (Configuration::feature_transform() == false) {
+                // The neighbourhood holds bound-only placeholders, so the capture subset is
+                // recomputed here to look up any existing vertex for the child
+                Bitmask & buffer = State::locals()[id].columns[0];
                 for (int sign = -1; sign <= 1; sign += 2) {
-                    key_type child_key(State::locals[id].neighbourhood[2 * j + (sign < 0 ? 0 : 1)].capture_set(), 0);
-                    vertex_accessor child;
-                    if (State::graph.vertices.find(child, child_key)) {
-                        State::locals[id].neighbourhood[2 * j + (sign < 0 ? 0 : 1)] = child -> second;
+                    buffer = task.capture_set();
+                    State::dataset().subset(j, sign > 0, buffer);
+                    key_type child_key(buffer, 0);
+                    const_vertex_accessor child;
+                    if (State::graph().vertices.find(child, child_key)) {
+                        State::locals()[id].neighbourhood[2 * j + (sign < 0 ? 0 : 1)] = child -> second;
                     }
                 }
             }
 
-            Task & left = State::locals[id].neighbourhood[2 * j];
-            Task & right = State::locals[id].neighbourhood[2 * j + 1];
+            Task & left = State::locals()[id].neighbourhood[2 * j];
+            Task & right = State::locals()[id].neighbourhood[2 * j + 1];
 
             float split_lower, split_upper;
-            if (Configuration::rule_list) {
+            if (Configuration::rule_list()) {
                 float lower_negative = left.lowerbound() + right.base_objective();
                 float lower_positive = left.base_objective() + right.lowerbound();
                 split_lower = std::min(lower_negative, lower_positive);
@@ -206,7 +278,7 @@ void Optimizer::store_children(Task & task, unsigned int id) {
                 split_lower = left.lowerbound() + right.lowerbound();
                 split_upper = left.upperbound() + right.upperbound();
             }
-            bounds -> second.push_back(std::tuple<int, float, float>(j, split_lower, split_upper));
+            bounds -> second.push_back(std::make_tuple(j, split_lower, split_upper, unindexed_vertex, unindexed_vertex));
             if (split_lower > task.upperscope()) { continue; }
             if (split_upper < upper) { optimal_feature = j; }
             lower = std::min(lower, split_lower);
@@ -216,41 +288,128 @@ void Optimizer::store_children(Task & task, unsigned int id) {
     task.update(lower, upper, optimal_feature);
 }
 
-void Optimizer::link_to_parent(Tile const & parent, Bitmask const & features, Bitmask const & signs, float scope, Tile const & self, translation_type const & order, adjacency_accessor & parents) {
+void Optimizer::link_to_parent(Tile const & parent, Bitmask const & features, Bitmask const & signs, float scope, Tile const & self, unsigned int self_index, shared_translation const & order, adjacency_accessor & parents) {
     for (int j_begin = 0, j_end = 0; features.scan_range(true, j_begin, j_end); j_begin = j_end) {
         for (int j = j_begin; j < j_end; ++j) {
             int feature = (signs.get(j) ? 1 : -1) * (j + 1);
-            State::graph.translations.insert(std::make_pair(std::make_pair(parent, feature), order)); // insert translation
-            State::graph.children.insert(std::make_pair(std::make_pair(parent, feature), self)); // insert forward look-up entry
-            State::graph.edges.insert(parents, self); // insert backward look-up entry
+            State::graph().translations.insert(std::make_pair(std::make_pair(parent, feature), order)); // insert translation
+            State::graph().children.insert(std::make_pair(std::make_pair(parent, feature), self_index)); // insert forward look-up entry
+            State::graph().edges.insert(parents, self); // insert backward look-up entry
             std::pair<adjacency_iterator, bool> insertion = parents -> second.insert(
-                std::make_pair(parent, std::make_pair(Bitmask(State::dataset.width(), false), scope)));
+                std::make_pair(parent, std::make_pair(Bitmask(State::dataset().width(), false), scope)));
             insertion.first -> second.first.set(j, true);
             insertion.first -> second.second = std::min(insertion.first -> second.second, scope);
         }
     }
 }
 
-void Optimizer::signal_exploiters(adjacency_accessor & parents, Task & self, unsigned int id) {
+void Optimizer::signal_exploiters(adjacency_accessor & parents, Task const & self, unsigned int id) {
     if (self.uncertainty() != 0 && self.lowerbound() < self.lowerscope() - std::numeric_limits<float>::epsilon()) { return; }
     for (adjacency_iterator iterator = parents -> second.begin(); iterator != parents -> second.end(); ++iterator) {
         if (iterator -> second.first.count() == 0) { continue; }
         if (self.lowerbound() < iterator -> second.second - std::numeric_limits<float>::epsilon() && self.uncertainty() > 0) { continue; }
-        State::locals[id].outbound_message.exploitation(
+        State::locals()[id].outbound_message.exploitation(
             self.identifier(), // sender tile
             iterator -> first, // recipient tile
             iterator -> second.first, // recipient features
-            self.support() - self.lowerbound()); // priority
-        State::queue.push(State::locals[id].outbound_message);
+            self.exploration_priority()); // priority
+        State::queue().push(std::move(State::locals()[id].outbound_message));
         // iterator -> second.first.clear(); // reset the dependencies so we don't repeat exploits
     }
 }
 
-bool Optimizer::update_root(float lower, float upper) {
+bool Optimizer::update_root(float lower, float upper, unsigned int id) {
     bool change = lower != this -> global_lowerbound || upper != this -> global_upperbound;
+    if (change) { State::locals()[id].tally_bound_updates += 1; }
+    if (Configuration::anytime() && upper < this -> global_upperbound) { this -> incumbent_stale = true; }
+    // A drop this large invalidates bounds across the whole graph at once, so schedule a
+    // graph-wide tightening sweep instead of letting the improvement diffuse edge by edge
+    if (this -> global_upperbound - upper > Configuration::regularization()) { this -> tightening_stale = true; }
     this -> global_lowerbound = lower;
     this -> global_upperbound = upper;
     this -> global_lowerbound = std::min(this -> global_upperbound, this -> global_lowerbound);
     this -> global_boundary = global_upperbound - global_lowerbound;
     return change;
 }
+
+void Optimizer::tighten_graph(unsigned int id) {
+    // The vertex table does not support traversal concurrent with insertion, so the sweep
+    // enumerates the interned identifier vector instead: it only grows, every index below
+    // the snapshot count resolves while workers keep inserting, and vertices interned after
+    // the snapshot carry fresh bounds that need no tightening
+    unsigned int const snapshot = State::graph().interned_count();
+
+    bool const condemnable = Configuration::memory_limit() > 0 && !Configuration::reference_LB();
+    // Pool threads are not bound to this fit's context, so each chunk binds the sweeping
+    // worker's context and configuration for its duration, as extraction does
+    State::Context * const context = & State::active();
+    Configuration::Values * const settings = & Configuration::active();
+    tbb::parallel_for(tbb::blocked_range< unsigned int >(0, snapshot), [&](tbb::blocked_range< unsigned int > const & range) {
+        State::Context * const previous_context = State::binding();
+        Configuration::Values * const previous_settings = Configuration::binding();
+        State::bind(context);
+        Configuration::bind(settings);
+        for (unsigned int index = range.begin(); index < range.end(); ++index) {
+            key_type const & identifier = State::graph().identifier(index);
+            // The sweep only tightens bounds through the packed atomics, so shared accessors
+            // suffice and the pass stalls neither the workers nor its own parallel iterations
+            const_vertex_accessor vertex;
+            if (!State::graph().vertices.find(vertex, identifier)) { continue; } // Reclaimed since it was interned
+            Task const & task = vertex -> second;
+            if (task.uncertainty() == 0) { continue; }
+
+            bound_accessor bounds;
+            if (State::graph().bounds.find(bounds, identifier)) {
+                float lower = task.base_objective(), upper = task.base_objective();
+                int optimal_feature = -1;
+                for (bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
+                    unsigned int const negative_index = std::get<3>(* iterator);
+                    unsigned int const positive_index = std::get<4>(* iterator);
+                    const_vertex_accessor left, right;
+                    // Accessors are only ever taken parent-then-child here and in dispatch, and
+                    // the graph is acyclic, so the sweep cannot deadlock against the workers
+                    if (negative_index != unindexed_vertex && positive_index != unindexed_vertex
+                        && State::graph().vertices.find(left, State::graph().identifier(negative_index))
+                        && State::graph().vertices.find(right, State::graph().identifier(positive_index))) {
+                        float split_lower, split_upper;
+                        if (Configuration::rule_list()) {
+                            float lower_negative = left -> second.lowerbound() + right -> second.base_objective();
+                            float lower_positive = left -> second.base_objective() + right -> second.lowerbound();
+                            split_lower = std::min(lower_negative, lower_positive);
+                            float upper_negative = left -> second.upperbound() + right -> second.base_objective();
+                            float upper_positive = left -> second.base_objective() + right -> second.upperbound();
+                            split_upper = std::min(upper_negative, upper_positive);
+                        } else {
+                            split_lower = left -> second.lowerbound() + right -> second.lowerbound();
+                            split_upper = left -> second.upperbound() + right -> second.upperbound();
+                        }
+                        // Only adopt refreshed bounds where they tighten, so values inferred by
+                        // other passes, such as the similar support comparison, are never loosened
+                        std::get<1>(* iterator) = std::max(std::get<1>(* iterator), split_lower);
+                        std::get<2>(* iterator) = std::min(std::get<2>(* iterator), split_upper);
+                    }
+                    if (std::get<1>(* iterator) > task.upperscope()) { continue; }
+                    if (std::get<2>(* iterator) < upper) { optimal_feature = std::get<0>(* iterator); }
+                    lower = std::min(lower, std::get<1>(* iterator));
+                    upper = std::min(upper, std::get<2>(* iterator));
+                }
+                task.update(lower, upper, optimal_feature);
+            }
+
+            // Cancel dead subtrees in bulk using the same domination test the exploitation
+            // path applies one vertex at a time
+            if (condemnable && task.lowerbound() >= task.upperscope() - std::numeric_limits<float>::epsilon()) {
+                State::graph().condemn(identifier);
+            }
+        }
+        State::bind(previous_context);
+        Configuration::bind(previous_settings);
+    });
+
+    // Fold the root's refreshed bounds into the global boundary immediately rather than
+    // waiting for the next exploitation message to reach the root
+    const_vertex_accessor root_vertex;
+    if (load_self(this -> root, root_vertex)) {
+        update_root(root_vertex -> second.lowerbound(), root_vertex -> second.upperbound(), id);
+    }
+}
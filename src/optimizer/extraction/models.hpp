@@ -1,6 +1,62 @@
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace {
+    // @returns the memoized model count of a vertex during the read-only extraction phase
+    // @note model_count(root) visits every vertex that extraction can reach, so a memo miss
+    //       only occurs for vertices that contribute no models
+    unsigned long long stored_model_count(key_type const & identifier, std::unordered_map< key_type, unsigned long long > const & counts) {
+        auto memo = counts.find(identifier);
+        return memo == counts.end() ? 0 : memo -> second;
+    }
+
+    // @param count: number of models produced by the extraction
+    // @param seconds: elapsed optimization time when extraction finished
+    // @modifies appends a one-line extraction record to Configuration::profile()
+    void profile_extraction(unsigned long long count, float seconds) {
+        if (Configuration::profile() == "") { return; }
+        json sample = json::object();
+        sample["stage"] = "extraction";
+        sample["time"] = seconds;
+        sample["models"] = count;
+        std::ofstream profile_output(Configuration::profile(), std::ios_base::app);
+        profile_output << sample.dump() << std::endl;
+        profile_output.flush();
+    }
+}
+
 void Optimizer::models(std::unordered_set< Model > & results) {
-    if (Configuration::model_limit == 0) { return; }
+    if (Configuration::model_limit() == 0) { return; }
+    if (!Configuration::rule_list()) {
+        // Counting is a cheap sequential pass; building the models is the expensive part, and
+        // the dependency graph is read-only here, so the ranks extract in parallel with each
+        // model landing in its own slot before the sequential deduplicating merge
+        std::unordered_map< key_type, unsigned long long > counts;
+        unsigned long long total = model_count(this -> root, counts);
+        std::vector< std::shared_ptr< Model > > extracted(total);
+        // TBB pool threads are not bound to this fit's context, so each chunk binds the
+        // calling thread's context and configuration for its duration; otherwise extract
+        // would read an empty default context on a pool thread and drop its ranks
+        State::Context * const context = & State::active();
+        Configuration::Values * const settings = & Configuration::active();
+        tbb::parallel_for(tbb::blocked_range< unsigned long long >(0, total), [&](tbb::blocked_range< unsigned long long > const & range) {
+            State::Context * const previous_context = State::binding();
+            Configuration::Values * const previous_settings = Configuration::binding();
+            State::bind(context);
+            Configuration::bind(settings);
+            for (unsigned long long rank = range.begin(); rank != range.end(); ++rank) {
+                extracted[rank] = extract(this -> root, rank, counts);
+            }
+            State::bind(previous_context);
+            Configuration::bind(previous_settings);
+        });
+        for (unsigned long long rank = 0; rank < total && results.size() < Configuration::model_limit(); ++rank) {
+            if (extracted[rank] != nullptr) { results.insert(* extracted[rank]); }
+        }
+        profile_extraction(results.size(), elapsed());
+        return;
+    }
     std::unordered_set< Model *, std::hash< Model * >, std::equal_to< Model * > > local_results;
     models(this -> root, local_results);
     // std::cout << "Local Size: " << local_results.size() << std::endl;
@@ -20,17 +76,290 @@ void Optimizer::models(std::unordered_set< Model > & results) {
     }
     // std::cout << "Local Size: " << local_results.size() << std::endl;
     // std::cout << "Result Size: " << results.size() << std::endl;
+    profile_extraction(results.size(), elapsed());
+}
+
+void Optimizer::models(std::function< void(Model &) > const & emit) {
+    if (Configuration::model_limit() == 0) { return; }
+    if (Configuration::rule_list()) {
+        // Rule list extraction filters each candidate on its own risk, so the models of a
+        // vertex cannot be counted without building them; materialize the set as before
+        std::unordered_set< Model > results;
+        models(results);
+        for (auto iterator = results.begin(); iterator != results.end(); ++iterator) {
+            Model model = * iterator;
+            emit(model);
+        }
+        return;
+    }
+
+    // Rank enumeration: each vertex exposes a fixed ordering of its models (the leaf option
+    // first, then the cross products of each surviving split), so the rank-th model of the
+    // root can be built by decomposing the rank along one root-to-leaf derivation at a time.
+    // Only that derivation is in memory while a model is built
+    std::unordered_map< key_type, unsigned long long > counts;
+    unsigned long long total = model_count(this -> root, counts);
+    std::unordered_set< size_t > emitted; // Distinct derivations can build the same tree; dedupe by structural hash
+    // Ranks build in parallel one block at a time, then emit in rank order, so the callback
+    // sees a deterministic sequence while memory stays bounded by the block
+    unsigned long long const block = 256;
+    std::vector< std::shared_ptr< Model > > buffer;
+    // As in the set overload, pool threads bind the caller's context per chunk so extract
+    // resolves the graph and configuration of this fit rather than an empty default
+    State::Context * const context = & State::active();
+    Configuration::Values * const settings = & Configuration::active();
+    for (unsigned long long start = 0; start < total && emitted.size() < Configuration::model_limit(); start += block) {
+        unsigned long long finish = std::min(total, start + block);
+        buffer.assign(finish - start, nullptr);
+        tbb::parallel_for(tbb::blocked_range< unsigned long long >(start, finish), [&](tbb::blocked_range< unsigned long long > const & range) {
+            State::Context * const previous_context = State::binding();
+            Configuration::Values * const previous_settings = Configuration::binding();
+            State::bind(context);
+            Configuration::bind(settings);
+            for (unsigned long long rank = range.begin(); rank != range.end(); ++rank) {
+                buffer[rank - start] = extract(this -> root, rank, counts);
+            }
+            State::bind(previous_context);
+            Configuration::bind(previous_settings);
+        });
+        for (unsigned long long rank = start; rank < finish && emitted.size() < Configuration::model_limit(); ++rank) {
+            std::shared_ptr< Model > model = buffer[rank - start];
+            if (model == nullptr) { continue; }
+            if (!emitted.insert(model -> hash()).second) { continue; }
+            emit(* model);
+        }
+    }
+    profile_extraction(emitted.size(), elapsed());
+}
+
+void Optimizer::incumbent(void) {
+    if (Configuration::model() == "") { return; }
+    std::shared_ptr< Model > model = incumbent_model(this -> root);
+    if (model == nullptr) { return; }
+    float lowerbound, upperbound;
+    objective_boundary(& lowerbound, & upperbound);
+    std::string serialization;
+    model -> serialize(serialization, 2);
+    json record = json::object();
+    record["time"] = elapsed();
+    record["lowerbound"] = lowerbound;
+    record["upperbound"] = upperbound;
+    record["gap"] = upperbound - lowerbound;
+    record["model"] = json::parse(serialization);
+    // Staged write and rename so a run killed mid-write never leaves a torn model file
+    std::string staging = Configuration::model() + ".partial";
+    std::ofstream snapshot_output(staging, std::ios_base::trunc);
+    snapshot_output << record.dump(2);
+    snapshot_output.flush();
+    snapshot_output.close();
+    std::rename(staging.c_str(), Configuration::model().c_str());
+}
+
+std::shared_ptr< Model > Optimizer::incumbent_model(key_type const & identifier) {
+    const_vertex_accessor task_accessor;
+    if (State::graph().vertices.find(task_accessor, identifier) == false) { return nullptr; }
+    Task const & task = task_accessor -> second;
+
+    // The leaf option holds the incumbent until some split's upperbound beats it
+    float best = task.base_objective();
+    int best_feature = 0;
+    bool split = false;
+    const_bound_accessor bounds;
+    if (State::graph().bounds.find(bounds, identifier)) {
+        for (const_bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
+            if (std::get<2>(* iterator) < best - std::numeric_limits<float>::epsilon()) {
+                best = std::get<2>(* iterator);
+                best_feature = std::get<0>(* iterator);
+                split = true;
+            }
+        }
+    }
+    bounds.release();
+
+    if (!split) {
+        std::shared_ptr< Model > model(new Model(std::shared_ptr<Bitmask>(new Bitmask(task.capture_set()))));
+        model -> identify(identifier);
+        model -> translate_self(task.order());
+        return model;
+    }
+
+    int const feature = best_feature;
+    bool negative_identified = false, positive_identified = false;
+    key_type negative_identifier, positive_identifier;
+    const_child_accessor left_key, right_key;
+    if (State::graph().children.find(left_key, std::make_pair(identifier, -(feature + 1)))) {
+        negative_identifier = State::graph().identifier(left_key -> second);
+        negative_identified = true;
+        left_key.release();
+    }
+    if (State::graph().children.find(right_key, std::make_pair(identifier, feature + 1))) {
+        positive_identifier = State::graph().identifier(right_key -> second);
+        positive_identified = true;
+        right_key.release();
+    }
+
+    std::shared_ptr< Model > negative, positive;
+    if (negative_identified) {
+        negative = incumbent_model(negative_identifier);
+    } else {
+        Bitmask subset(task.capture_set());
+        State::dataset().subset(feature, false, subset);
+        negative = std::shared_ptr< Model >(new Model(std::shared_ptr<Bitmask>(new Bitmask(subset))));
+    }
+    if (positive_identified) {
+        positive = incumbent_model(positive_identifier);
+    } else {
+        Bitmask subset(task.capture_set());
+        State::dataset().subset(feature, true, subset);
+        positive = std::shared_ptr< Model >(new Model(std::shared_ptr<Bitmask>(new Bitmask(subset))));
+    }
+    if (negative == nullptr || positive == nullptr) { return nullptr; }
+
+    std::shared_ptr< Model > model(new Model(feature, negative, positive));
+    model -> identify(identifier);
+    model -> translate_self(task.order());
+    const_translation_accessor negative_translation, positive_translation;
+    if (negative -> identified()
+        && State::graph().translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
+        model -> translate_negatives(negative_translation -> second);
+    }
+    negative_translation.release();
+    if (positive -> identified()
+        && State::graph().translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
+        model -> translate_positives(positive_translation -> second);
+    }
+    positive_translation.release();
+    return model;
+}
+
+unsigned long long Optimizer::model_count(key_type const & identifier, std::unordered_map< key_type, unsigned long long > & counts) {
+    auto memo = counts.find(identifier);
+    if (memo != counts.end()) { return memo -> second; }
+    vertex_accessor task_accessor;
+    if (State::graph().vertices.find(task_accessor, identifier) == false) { return 0; }
+    Task & task = task_accessor -> second;
+    unsigned long long const cap = Configuration::model_limit();
+
+    unsigned long long total = 0;
+    if (task.base_objective() <= task.upperbound() + std::numeric_limits<float>::epsilon()) { total += 1; }
+
+    bound_accessor bounds;
+    if (State::graph().bounds.find(bounds, identifier)) {
+        for (bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
+            if (std::get<2>(* iterator) > task.upperbound() + std::numeric_limits<float>::epsilon()) { continue; }
+            int feature = std::get<0>(* iterator);
+            unsigned long long negative_count = 1, positive_count = 1; // A missing child contributes exactly its leaf
+            child_accessor left_key, right_key;
+            if (State::graph().children.find(left_key, std::make_pair(identifier, -(feature + 1)))) {
+                key_type negative_identifier = State::graph().identifier(left_key -> second);
+                left_key.release();
+                negative_count = model_count(negative_identifier, counts);
+            }
+            if (State::graph().children.find(right_key, std::make_pair(identifier, feature + 1))) {
+                key_type positive_identifier = State::graph().identifier(right_key -> second);
+                right_key.release();
+                positive_count = model_count(positive_identifier, counts);
+            }
+            if (negative_count == 0 || positive_count == 0) { continue; }
+            unsigned long long pairs = negative_count > cap / positive_count ? cap : negative_count * positive_count;
+            total = std::min(cap, total + pairs);
+        }
+    }
+    total = std::min(cap, total);
+    counts[identifier] = total;
+    return total;
+}
+
+std::shared_ptr< Model > Optimizer::extract(key_type const & identifier, unsigned long long rank, std::unordered_map< key_type, unsigned long long > const & counts) {
+    // Read-only: const accessors let parallel extractions share each vertex without
+    // serializing on its write lock, and the memoized counts are never touched
+    const_vertex_accessor task_accessor;
+    if (State::graph().vertices.find(task_accessor, identifier) == false) { return nullptr; }
+    Task const & task = task_accessor -> second;
+    unsigned long long const cap = Configuration::model_limit();
+
+    if (task.base_objective() <= task.upperbound() + std::numeric_limits<float>::epsilon()) {
+        if (rank == 0) {
+            std::shared_ptr< Model > model(new Model(std::shared_ptr<Bitmask>(new Bitmask(task.capture_set()))));
+            model -> identify(identifier);
+            model -> translate_self(task.order());
+            return model;
+        }
+        rank -= 1;
+    }
+
+    const_bound_accessor bounds;
+    if (!State::graph().bounds.find(bounds, identifier)) { return nullptr; }
+
+    for (const_bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
+        if (std::get<2>(* iterator) > task.upperbound() + std::numeric_limits<float>::epsilon()) { continue; }
+        int feature = std::get<0>(* iterator);
+
+        bool negative_identified = false, positive_identified = false;
+        key_type negative_identifier, positive_identifier;
+        unsigned long long negative_count = 1, positive_count = 1;
+        const_child_accessor left_key, right_key;
+        if (State::graph().children.find(left_key, std::make_pair(identifier, -(feature + 1)))) {
+            negative_identifier = State::graph().identifier(left_key -> second);
+            negative_identified = true;
+            left_key.release();
+            negative_count = stored_model_count(negative_identifier, counts);
+        }
+        if (State::graph().children.find(right_key, std::make_pair(identifier, feature + 1))) {
+            positive_identifier = State::graph().identifier(right_key -> second);
+            positive_identified = true;
+            right_key.release();
+            positive_count = stored_model_count(positive_identifier, counts);
+        }
+        if (negative_count == 0 || positive_count == 0) { continue; }
+        unsigned long long pairs = negative_count > cap / positive_count ? cap : negative_count * positive_count;
+        if (rank >= pairs) { rank -= pairs; continue; }
+
+        std::shared_ptr< Model > negative, positive;
+        if (negative_identified) {
+            negative = extract(negative_identifier, rank / positive_count, counts);
+        } else {
+            Bitmask subset(task.capture_set());
+            State::dataset().subset(feature, false, subset);
+            negative = std::shared_ptr< Model >(new Model(std::shared_ptr<Bitmask>(new Bitmask(subset))));
+        }
+        if (positive_identified) {
+            positive = extract(positive_identifier, rank % positive_count, counts);
+        } else {
+            Bitmask subset(task.capture_set());
+            State::dataset().subset(feature, true, subset);
+            positive = std::shared_ptr< Model >(new Model(std::shared_ptr<Bitmask>(new Bitmask(subset))));
+        }
+        if (negative == nullptr || positive == nullptr) { return nullptr; }
+
+        std::shared_ptr< Model > model(new Model(feature, negative, positive));
+        model -> identify(identifier);
+        model -> translate_self(task.order());
+        const_translation_accessor negative_translation, positive_translation;
+        if (negative -> identified()
+            && State::graph().translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
+            model -> translate_negatives(negative_translation -> second);
+        }
+        negative_translation.release();
+        if (positive -> identified()
+            && State::graph().translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
+            model -> translate_positives(positive_translation -> second);
+        }
+        positive_translation.release();
+        return model;
+    }
+    return nullptr;
 }
 
 void Optimizer::models(key_type const & identifier, std::unordered_set< Model *, std::hash< Model * >, std::equal_to< Model * > > & results, bool leaf) {
     vertex_accessor task_accessor;
-    if (State::graph.vertices.find(task_accessor, identifier) == false) { return; }
+    if (State::graph().vertices.find(task_accessor, identifier) == false) { return; }
     Task & task = task_accessor -> second;
     // std::cout << "Base Condition: " << task.base_objective() << " <= " << task.upperbound() << " = " << (int)(task.base_objective() <= task.upperbound()) << std::endl;
 
     // std::cout << "Capture: " << task.capture_set().to_string() << std::endl;
     if (task.base_objective() <= task.upperbound() + std::numeric_limits<float>::epsilon()) {
-        // || (Configuration::rule_list && task.capture_set().count() != task.capture_set().size())) {
+        // || (Configuration::rule_list() && task.capture_set().count() != task.capture_set().size())) {
         // std::cout << "Stump" << std::endl;
         // std::shared_ptr<key_type> stump(new Tile(set));
         // Model stump_key(stump_set); // shallow variant
@@ -43,7 +372,7 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
     }
 
     bound_accessor bounds;
-    if (!State::graph.bounds.find(bounds, identifier)) { return; }
+    if (!State::graph().bounds.find(bounds, identifier)) { return; }
 
     for (bound_iterator iterator = bounds -> second.begin(); iterator != bounds -> second.end(); ++iterator) {
         // std::cout << "Bound" << std::endl;
@@ -56,46 +385,46 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
         bool ready = true;
 
         child_accessor left_key, right_key;
-        if (State::graph.children.find(left_key, std::make_pair(identifier, -(feature + 1)))) {    
-            models(left_key -> second, negatives);
+        if (State::graph().children.find(left_key, std::make_pair(identifier, -(feature + 1)))) {
+            models(State::graph().identifier(left_key -> second), negatives);
             left_key.release();
         } else {
             Bitmask subset(task.capture_set());
-            State::dataset.subset(feature, false, subset);
+            State::dataset().subset(feature, false, subset);
             Model * model = new Model(std::shared_ptr<Bitmask>(new Bitmask(subset)));
             negatives.insert(model);
         }
-        if (State::graph.children.find(right_key, std::make_pair(identifier, feature + 1))) {
-            models(right_key -> second, positives);
+        if (State::graph().children.find(right_key, std::make_pair(identifier, feature + 1))) {
+            models(State::graph().identifier(right_key -> second), positives);
             right_key.release();
         } else {
             Bitmask subset(task.capture_set());
-            State::dataset.subset(feature, true, subset);
+            State::dataset().subset(feature, true, subset);
             Model * model = new Model(std::shared_ptr<Bitmask>(new Bitmask(subset)));
             positives.insert(model);
         }
 
         if (negatives.size() == 0 || positives.size() == 0) { continue; }
         
-        if (Configuration::rule_list) {
+        if (Configuration::rule_list()) {
             float potential, min_loss, guaranteed_min_loss, info, left_leaf_risk, right_leaf_risk;
             unsigned int target_index;
-            Bitmask negative_subset(State::dataset.height());
-            Bitmask positive_subset(State::dataset.height());
+            Bitmask negative_subset(State::dataset().height());
+            Bitmask positive_subset(State::dataset().height());
             negative_subset = task.capture_set();
-            State::dataset.subset(feature, false, negative_subset);
-            State::dataset.summary(negative_subset, info, potential, min_loss, guaranteed_min_loss, left_leaf_risk, target_index, 0);
+            State::dataset().subset(feature, false, negative_subset);
+            State::dataset().summary(negative_subset, info, potential, min_loss, guaranteed_min_loss, left_leaf_risk, target_index, 0);
             positive_subset = task.capture_set();
-            State::dataset.subset(feature, true, positive_subset);
-            State::dataset.summary(positive_subset, info, potential, min_loss, guaranteed_min_loss, right_leaf_risk, target_index, 0);
+            State::dataset().subset(feature, true, positive_subset);
+            State::dataset().summary(positive_subset, info, potential, min_loss, guaranteed_min_loss, right_leaf_risk, target_index, 0);
 
-            left_leaf_risk += Configuration::regularization;
-            right_leaf_risk += Configuration::regularization;
+            left_leaf_risk += Configuration::regularization();
+            right_leaf_risk += Configuration::regularization();
 
             for (auto negative_it = negatives.begin(); negative_it != negatives.end(); ++negative_it) {
                 float risk = right_leaf_risk + (**negative_it).loss() + (**negative_it).complexity();                
                 if (risk <= task.upperbound() + std::numeric_limits<float>::epsilon()) {
-                    if (Configuration::model_limit > 0 && results.size() >= Configuration::model_limit) { continue; }
+                    if (Configuration::model_limit() > 0 && results.size() >= Configuration::model_limit()) { continue; }
 
                     std::shared_ptr<Model> negative(* negative_it);
                     std::shared_ptr<Model> positive(new Model(std::shared_ptr<Bitmask>(new Bitmask(positive_subset))));
@@ -105,12 +434,12 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
                     model -> translate_self(task.order());
                     translation_accessor negative_translation, positive_translation;
                     if (negative -> identified()
-                        && State::graph.translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
+                        && State::graph().translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
                         model -> translate_negatives(negative_translation -> second);
                     }
                     negative_translation.release();
                     if (positive -> identified()
-                        && State::graph.translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
+                        && State::graph().translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
                         model -> translate_positives(positive_translation -> second);
                     }
                     positive_translation.release();
@@ -120,7 +449,7 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
             for (auto positive_it = positives.begin(); positive_it != positives.end(); ++positive_it) {
                 float risk = left_leaf_risk + (**positive_it).loss() + (**positive_it).complexity();
                 if (risk <= task.upperbound() + std::numeric_limits<float>::epsilon()) {
-                    if (Configuration::model_limit > 0 && results.size() >= Configuration::model_limit) { continue; }
+                    if (Configuration::model_limit() > 0 && results.size() >= Configuration::model_limit()) { continue; }
 
                     std::shared_ptr<Model> negative(new Model(std::shared_ptr<Bitmask>(new Bitmask(negative_subset))));
                     std::shared_ptr<Model> positive(* positive_it);
@@ -130,12 +459,12 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
                     model -> translate_self(task.order());
                     translation_accessor negative_translation, positive_translation;
                     if (negative -> identified()
-                        && State::graph.translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
+                        && State::graph().translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
                         model -> translate_negatives(negative_translation -> second);
                     }
                     negative_translation.release();
                     if (positive -> identified()
-                        && State::graph.translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
+                        && State::graph().translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
                         model -> translate_positives(positive_translation -> second);
                     }
                     positive_translation.release();
@@ -146,7 +475,7 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
             for (auto negative_it = negatives.begin(); negative_it != negatives.end(); ++negative_it) {
                 for (auto positive_it = positives.begin(); positive_it != positives.end(); ++positive_it) {
 
-                    if (Configuration::model_limit > 0 && results.size() >= Configuration::model_limit) { continue; }
+                    if (Configuration::model_limit() > 0 && results.size() >= Configuration::model_limit()) { continue; }
                     
                     std::shared_ptr<Model> negative(* negative_it);
                     std::shared_ptr<Model> positive(* positive_it);
@@ -155,12 +484,12 @@ void Optimizer::models(key_type const & identifier, std::unordered_set< Model *,
                     model -> translate_self(task.order());
                     translation_accessor negative_translation, positive_translation;
                     if ((** negative_it).identified()
-                        && State::graph.translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
+                        && State::graph().translations.find(negative_translation, std::make_pair(identifier, -(feature + 1)))) {
                         model -> translate_negatives(negative_translation -> second);
                     }
                     negative_translation.release();
                     if ((** positive_it).identified()
-                        && State::graph.translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
+                        && State::graph().translations.find(positive_translation, std::make_pair(identifier, feature + 1))) {
                         model -> translate_positives(positive_translation -> second);
                     }
                     positive_translation.release();
@@ -13,6 +13,7 @@ static PyObject * configure(PyObject * self, PyObject * args) {
 
 // @param args: contains a single string object which contains the training data in CSV form
 // @returns a string object containing a JSON array of all resulting models
+// @note the GIL is released for the duration of training so other Python threads keep running
 static PyObject * fit(PyObject * self, PyObject * args) {
     const char * dataset;
     if (!PyArg_ParseTuple(args, "s", & dataset)) { return NULL; }
@@ -20,7 +21,39 @@ static PyObject * fit(PyObject * self, PyObject * args) {
     std::istringstream data_stream(dataset);
     GOSDT model;
     std::string result;
+    Py_BEGIN_ALLOW_THREADS
     model.fit(data_stream, result);
+    Py_END_ALLOW_THREADS
+
+    return Py_BuildValue("s", result.c_str());
+}
+
+// @param args: contains a single object exposing the buffer protocol as a C-contiguous
+//   2D array of single-byte elements (e.g. a NumPy uint8 matrix), where the first
+//   columns - 1 entries of each row are 0/1 features and the last entry is the class label
+// @returns a string object containing a JSON array of all resulting models
+// @note the matrix is read in place; no CSV serialization, copy or parse takes place
+// @note the GIL is released for the duration of training so other Python threads keep running
+static PyObject * fit_matrix(PyObject * self, PyObject * args) {
+    PyObject * source;
+    if (!PyArg_ParseTuple(args, "O", & source)) { return NULL; }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(source, & view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) { return NULL; }
+    if (view.ndim != 2 || view.itemsize != 1) {
+        PyBuffer_Release(& view);
+        PyErr_SetString(PyExc_ValueError, "fit_matrix expects a C-contiguous 2D array of single-byte elements");
+        return NULL;
+    }
+    unsigned int samples = view.shape[0];
+    unsigned int columns = view.shape[1];
+
+    GOSDT model;
+    std::string result;
+    Py_BEGIN_ALLOW_THREADS
+    model.fit((unsigned char const *) view.buf, samples, columns, result);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(& view);
 
     return Py_BuildValue("s", result.c_str());
 }
@@ -73,6 +106,7 @@ static PyMethodDef libgosdt_methods[] = {
     // { method name, method pointer, method parameter format, method description }
     {"configure", configure, METH_VARARGS, "Configures the algorithm using an input JSON string"},
     {"fit", fit, METH_VARARGS, "Trains the model using an input CSV string"},
+    {"fit_matrix", fit_matrix, METH_VARARGS, "Trains the model using a binarized 2D uint8 array, zero-copy"},
     {"time", time, METH_NOARGS, "Number of seconds spent training"},
     {"iterations", iterations, METH_NOARGS, "Number of iterations spent training"},
     {"size", size, METH_NOARGS, "Number of vertices in the depency graph"},
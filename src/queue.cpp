@@ -1,41 +1,147 @@
 #include "queue.hpp"
 
-Queue::Queue(void) {
-    return;
+#include <algorithm>
+
+namespace {
+    // Workers are assigned a home shard round-robin, in order of first access
+    std::atomic< unsigned int > next_ticket(0);
+    thread_local unsigned int const thread_ticket = next_ticket++;
+}
+
+tbb::concurrent_queue< message_type * > Queue::pool = tbb::concurrent_queue< message_type * >();
+
+std::mutex Queue::parking_mutex;
+std::condition_variable Queue::parking_signal;
+std::atomic< unsigned int > Queue::parked(0);
+
+Queue::Queue(void) : shards(std::max(1U, Configuration::worker_limit())) {
+    // Pooled messages carry buffers sized for the previously loaded dataset, which cannot be
+    // safely resized, so the pool is drained whenever a new queue is constructed
+    message_type * stale;
+    while (Queue::pool.try_pop(stale)) { delete stale; }
 }
 
 Queue::~Queue(void) {
     return;
 }
 
+message_type * Queue::acquire(void) {
+    message_type * message;
+    if (Queue::pool.try_pop(message)) { return message; }
+    return NULL;
+}
+
+void Queue::recycle(message_type * message) {
+    Queue::pool.push(message);
+}
+
 bool Queue::push(Message const & message) {
-    message_type * internal_message = new message_type();
+    message_type * internal_message = Queue::acquire();
+    if (internal_message == NULL) { internal_message = new message_type(); }
     * internal_message = message;
 
-    // Attempt to copy content into membership set
-    if (this -> membership.insert(std::make_pair(internal_message, true))) {
-        this -> queue.push(internal_message);
+    return admit(internal_message);
+}
+
+bool Queue::push(Message && message) {
+    message_type * internal_message = Queue::acquire();
+    if (internal_message == NULL) {
+        // The pool only holds messages that completed a full cycle and therefore carry
+        // correctly sized buffers; a fresh message has none, so copy instead of swapping
+        // to avoid handing empty buffers back to the caller
+        internal_message = new message_type();
+        * internal_message = message;
+    } else {
+        internal_message -> swap(message);
+    }
+
+    return admit(internal_message);
+}
+
+bool Queue::admit(message_type * internal_message) {
+    // Messages shard by hash so that duplicates always probe the same membership table
+    Shard & shard = this -> shards[internal_message -> hash() % this -> shards.size()];
+
+    // Attempt to insert content into membership set
+    membership_table_type::accessor slot;
+    if (shard.membership.insert(slot, internal_message)) {
+        slot.release();
+        shard.queue.push(internal_message);
+        // Wake a parked worker; the counter keeps the lock off the fast path
+        if (Queue::parked.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard< std::mutex > guard(Queue::parking_mutex);
+            Queue::parking_signal.notify_one();
+        }
         return true;
     } else {
-        delete internal_message;
+        // Merge into the already-queued message while holding only its element accessor;
+        // the bucket lock was released as soon as the probe resolved
+        message_type * const resident = slot -> first;
+        internal_message -> features.bit_or(resident -> features);
+        internal_message -> signs.bit_or(resident -> signs);
+        resident -> scope = std::max(resident -> scope, internal_message -> scope);
+        slot.release();
+        Queue::recycle(internal_message);
         return false;
     }
 }
 
 bool Queue::empty(void) const { return size() == 0; }
 
-unsigned int Queue::size(void) const { return this -> queue.size(); }
-
+unsigned int Queue::size(void) const {
+    unsigned int total = 0;
+    for (unsigned int i = 0; i < this -> shards.size(); ++i) { total += this -> shards[i].queue.size(); }
+    return total;
+}
 
 bool Queue::pop(Message & message) {
+    unsigned int const count = this -> shards.size();
+    unsigned int const home = thread_ticket % count;
     message_type * internal_message;
-    if (this -> queue.try_pop(internal_message)) {
-        this -> membership.erase(internal_message); // remove membership
-        message = * internal_message;
+    // Pop from the home shard first, then steal from the remaining shards in round-robin order
+    for (unsigned int probe = 0; probe < count; ++probe) {
+        Shard & shard = this -> shards[(home + probe) % count];
+        if (shard.queue.try_pop(internal_message)) {
+            shard.membership.erase(internal_message); // remove membership
+            internal_message -> swap(message);
 
-        delete internal_message;
-        return true;
-    } else {
-        return false;
+            Queue::recycle(internal_message);
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned int Queue::pop_batch(std::vector< Message > & batch, unsigned int limit) {
+    unsigned int const count = this -> shards.size();
+    unsigned int const home = thread_ticket % count;
+    unsigned int extracted = 0;
+    limit = std::min(limit, (unsigned int)(batch.size()));
+    message_type * internal_message;
+    for (unsigned int probe = 0; probe < count && extracted < limit; ++probe) {
+        Shard & shard = this -> shards[(home + probe) % count];
+        while (extracted < limit && shard.queue.try_pop(internal_message)) {
+            shard.membership.erase(internal_message); // remove membership
+            internal_message -> swap(batch[extracted]);
+            Queue::recycle(internal_message);
+            extracted += 1;
+        }
+    }
+    return extracted;
+}
+
+void Queue::park(void) {
+    std::unique_lock< std::mutex > lock(Queue::parking_mutex);
+    Queue::parked.fetch_add(1, std::memory_order_relaxed);
+    // A push that landed between the failed pop and acquiring the lock makes waiting unnecessary
+    if (size() == 0) {
+        // The timeout bounds wake-up latency in case a wake-up is lost to a queue reset
+        Queue::parking_signal.wait_for(lock, std::chrono::milliseconds(100));
     }
+    Queue::parked.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Queue::awaken(void) {
+    std::lock_guard< std::mutex > guard(Queue::parking_mutex);
+    Queue::parking_signal.notify_all();
 }
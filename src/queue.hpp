@@ -1,12 +1,18 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <tuple>
 #include <unordered_set>
+#include <vector>
 
 #include <tbb/concurrent_priority_queue.h>
 #include <tbb/concurrent_hash_map.h>
+#include <tbb/concurrent_queue.h>
 #include <tbb/concurrent_vector.h>
 #include <tbb/scalable_allocator.h>
 
@@ -28,18 +34,11 @@ struct MembershipKeyHashCompare {
     static size_t hash(message_type * message) {
         return message -> hash();
     }
+    // Pure comparison; merging duplicates into the resident message happens in Queue::push
+    // under the element accessor, so the bucket lock held during hash probes never
+    // serializes mask merges
     static bool equal(message_type * left, message_type * right) {
-        if ((* left) == (* right)) {
-            left -> features.bit_or(right -> features);
-            right -> features.bit_or(left -> features);
-            left -> signs.bit_or(right -> signs);
-            right -> signs.bit_or(left -> signs);
-            left -> scope = std::max(left -> scope, right -> scope);
-            right -> scope = std::max(left -> scope, right -> scope);
-            return true;
-        } else {
-            return false;
-        }
+        return (* left) == (* right);
     }
 };
 
@@ -49,6 +48,13 @@ typedef tbb::concurrent_priority_queue< message_type *, PriorityKeyComparator,
 typedef tbb::concurrent_hash_map< message_type *, bool, MembershipKeyHashCompare, 
     tbb::scalable_allocator<std::pair<message_type * const, bool>>> membership_table_type; // FIREWOLF: Fix the static assertion error
 
+// Sharded priority queue
+// Messages are distributed over one shard per worker so that concurrent pushes and pops
+// contend on separate priority queues instead of a single global one
+// Each worker pops from a home shard assigned round-robin and steals from the remaining
+// shards when its home shard runs dry, so global priority order is only approximate
+// The branch-and-bound tolerates slightly out-of-order processing, so the relaxed order
+// trades a small amount of extra exploration for scalable throughput
 class Queue {
 public:
     Queue(void);
@@ -58,7 +64,13 @@ public:
     // @returns true if the message was successfully enqueued and not rejected by the membership filter
     // @note higher priority comes before lower priority
     bool push(Message const & message);
-    
+
+    // @param message: a message to be sent from one vertex to another
+    // @modifies message: the contents are swapped into pooled storage, leaving message with recycled (but valid) buffers
+    // @returns true if the message was successfully enqueued and not rejected by the membership filter
+    // @note higher priority comes before lower priority
+    bool push(Message && message);
+
     // @returns whether queue is empty
     bool empty(void) const;
 
@@ -71,11 +83,59 @@ public:
     // @modifes message: message will be overwritten with a copy the content of the received message
     bool pop(Message & message);
 
+    // Number of messages drained per worker visit; batching amortizes the queue
+    // synchronization and membership maintenance paid per message
+    static unsigned int const batch_limit = 32;
+
+    // @requires batch: every entry must carry pre-allocated buffers, as for pop
+    // @param batch: per-worker storage receiving the popped messages
+    // @param limit: the maximum number of messages to drain, at most batch.size()
+    // @returns the number of messages written into the front of batch
+    // @note drains the home shard in priority order before stealing from the remaining
+    //       shards, so a batch preserves the same approximate global order as repeated pops
+    unsigned int pop_batch(std::vector< Message > & batch, unsigned int limit);
+
+    // @modifies blocks the calling worker until a message is pushed, awaken is called,
+    //           or a bounded timeout elapses, instead of spinning on an empty queue
+    // @note callers must re-check their termination condition after waking
+    void park(void);
+
+    // @modifies wakes all parked workers, used to propagate termination promptly
+    static void awaken(void);
+
 private:
-    // map containing uniquely identified messages that are currently in queue
-    membership_table_type membership;
+    // One shard pairs a priority queue with the portion of the membership filter covering it
+    // Messages are assigned to shards by hash, so duplicate detection remains global
+    struct Shard {
+        // map containing uniquely identified messages that are currently in this shard
+        membership_table_type membership;
+
+        queue_type queue; // queue containing pending messages assigned to this shard
+    };
+
+    std::vector< Shard > shards; // One shard per worker
+
+    // Free list of recycled message objects; pooled messages keep their heap-backed buffers,
+    // so acquiring one avoids reallocating and recopying every mask in the message
+    // The pool is drained on queue construction because buffers are sized for one dataset
+    static tbb::concurrent_queue< message_type * > pool;
+
+    // Parking state shared across queue instances; workers wait here when the queue
+    // drains instead of burning cores polling pop
+    static std::mutex parking_mutex;
+    static std::condition_variable parking_signal;
+    static std::atomic< unsigned int > parked;
+
+    // @param internal_message: a pooled message carrying the content to enqueue
+    // @returns true if the message entered the queue; false if it merged into a duplicate
+    //          already queued in its shard, in which case it returns to the pool
+    bool admit(message_type * internal_message);
+
+    // @returns a recycled message with valid buffers, or NULL if the pool is empty
+    static message_type * acquire(void);
 
-    queue_type queue; // queue containing pending messages
+    // @param message: a message no longer in the queue, returned to the pool for reuse
+    static void recycle(message_type * message);
 };
 
 #endif
\ No newline at end of file
@@ -3,6 +3,10 @@
 std::vector<Bitmask> Reference::labels = std::vector<Bitmask>();
 
 void Reference::initialize_labels(std::istream & labels){
+    // Discard labels from any previous configuration; a resident process may configure
+    // reference models repeatedly
+    Reference::labels.clear();
+
     //read labels
     Encoder encoder(labels);
     std::vector<Bitmask>rows = encoder.read_binary_rows();
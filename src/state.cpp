@@ -1,24 +1,45 @@
 #include "state.hpp"
 
-Dataset State::dataset = Dataset();
-Graph State::graph = Graph();
-Queue State::queue = Queue();
-std::vector< LocalState > State::locals = std::vector< LocalState >();
-int State::status = 0;
+thread_local State::Context State::default_context = State::Context();
+thread_local State::Context * State::bound = NULL;
+
+State::Context & State::active(void) {
+    return State::bound == NULL ? State::default_context : * State::bound;
+}
+
+void State::bind(Context * context) { State::bound = context; }
+
+State::Context * State::binding(void) { return State::bound; }
 
 void State::initialize(std::istream & data_source, unsigned int workers) {
-    State::dataset.load(data_source);
-    State::graph = Graph();
-    State::queue = Queue();
-    State::locals.resize(workers);
-    for (unsigned int i = 0; i < workers; ++i) {
-        State::locals[i].initialize(dataset.height(), dataset.width(), dataset.depth());
-    }
+    State::dataset().load(data_source);
+    prepare(workers);
+}
+
+void State::initialize(unsigned char const * matrix, unsigned int samples, unsigned int columns, unsigned int workers) {
+    State::dataset().load(matrix, samples, columns);
+    prepare(workers);
 }
 
-void State::reset(void) {
-    State::graph = Graph();
-    State::queue = Queue();
-    State::locals.clear();
-    State::dataset.clear();
-}
\ No newline at end of file
+void State::initialize(unsigned int workers) {
+    prepare(workers);
+}
+
+void State::prepare(unsigned int workers) {
+    State::graph() = Graph();
+    State::queue() = Queue();
+    State::status() = 0;
+    State::locals().resize(workers);
+    // The remaining entries are initialized by their own worker threads, so that first-touch
+    // places each worker's scratch buffers on that worker's NUMA node. Entry 0 is initialized
+    // here because the main thread uses it to seed the root message before workers start
+    State::locals()[0].initialize(dataset().height(), dataset().width(), dataset().depth());
+}
+
+void State::reset(bool retain_dataset) {
+    State::graph() = Graph();
+    State::queue() = Queue();
+    State::locals().clear();
+    if (!retain_dataset) { State::dataset().clear(); }
+    State::status() = 0;
+}
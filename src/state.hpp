@@ -10,26 +10,73 @@ class State;
 
 // Container of all data structures capturing the state of the optimization
 // Here we separate the memory used by the algorithm into two spaces: Global and Local
-// Global space is memory that all threads have access to, but is either read-only or is protected by locking mechanisms
-// Local space is memory that is partitioned components such each thread has unrestriced access but only to one component
+// Global space is memory that all threads of a fit share access to, but is either read-only
+// or is protected by locking mechanisms
+// Local space is memory that is partitioned into components such that each thread has
+// unrestricted access but only to one component
 
 // Local space acts as an "extension" of the stack in a sense that the stack memory semantically belongs to a particular thread.
 // The actual location is stored on heap, although hypothetically we can store this on the stack
 
+// The state is grouped into a Context so that each fit can own its own instance: every thread
+// reads state through a bound context, so multiple fits can run concurrently in one process.
+// A thread that has not been bound (a caller running a standalone fit) uses its own
+// thread-local default context; GOSDT binds its instance context to its worker threads
 class State {
 public:
 
-    // Global state to which all thread shares access 
-    static Dataset dataset;
-    static Graph graph; 
-    static Queue queue;
-    static int status;
+    // The full optimization state of a single fit
+    struct Context {
+        Dataset dataset;
+        Graph graph;
+        Queue queue;
+        std::vector< LocalState > locals;
+        int status = 0;
+        // Set by worker 0 when resident memory nears Configuration::memory_limit; read by all
+        // workers without synchronization since a stale value only delays the policy change
+        bool pressure = false;
+    };
+
+    // @returns the context bound to the calling thread, or the thread's own default context
+    static Context & active(void);
+
+    // @param context: the context that the calling thread should operate on from now on
+    // @note passing NULL restores the thread's default context
+    static void bind(Context * context);
+
+    // @returns the context pointer currently bound to the calling thread, or NULL if the
+    //          thread operates on its default context; pass the result back to bind to
+    //          restore the thread after temporarily binding it to another context
+    static Context * binding(void);
+
+    // Global state to which all threads of a fit share access
+    static Dataset & dataset(void) { return active().dataset; }
+    static Graph & graph(void) { return active().graph; }
+    static Queue & queue(void) { return active().queue; }
+    static int & status(void) { return active().status; }
+    static bool & pressure(void) { return active().pressure; }
 
     // Local state to which each thread has exclusive access to a single entry
-    static std::vector< LocalState > locals;
+    static std::vector< LocalState > & locals(void) { return active().locals; }
 
     static void initialize(std::istream & data_source, unsigned int workers = 1);
-    static void reset(void);
+    static void initialize(unsigned char const * matrix, unsigned int samples, unsigned int columns, unsigned int workers = 1);
+
+    // @modifies resets the search structures while keeping the dataset already loaded into
+    //           the active context, so repeated fits over one dataset skip the load entirely
+    // @require a dataset was loaded into the active context by an earlier initialization
+    static void initialize(unsigned int workers);
+
+    // @param retain_dataset: when set, the loaded dataset survives the reset so the active
+    //        context can serve another fit without reloading it
+    static void reset(bool retain_dataset = false);
+
+private:
+    static thread_local Context default_context; // Fallback context for threads that are not bound
+    static thread_local Context * bound; // The context bound to the calling thread, if any
+
+    // @modifies resets the search structures and sizes the local state for the loaded dataset
+    static void prepare(unsigned int workers);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,20 +2,73 @@
 #include "graph.hpp"
 #include "state.hpp"
 
-Task::Task(void) {}
+#include <cstdlib>
+#include <cstring>
+
+// The bound pair travels as one word so concurrent readers always decode a lower and
+// upper bound that were stored together; the lower bound occupies the low half
+unsigned long long Task::pack_bounds(float lower, float upper) {
+    unsigned int lower_bits, upper_bits;
+    std::memcpy(& lower_bits, & lower, sizeof(float));
+    std::memcpy(& upper_bits, & upper, sizeof(float));
+    return (unsigned long long)(lower_bits) | ((unsigned long long)(upper_bits) << 32);
+}
+
+void Task::unpack_bounds(unsigned long long packed, float & lower, float & upper) {
+    unsigned int lower_bits = (unsigned int)(packed);
+    unsigned int upper_bits = (unsigned int)(packed >> 32);
+    std::memcpy(& lower, & lower_bits, sizeof(float));
+    std::memcpy(& upper, & upper_bits, sizeof(float));
+}
+
+Task::Task(void) {
+    this -> _bounds.store(pack_bounds(-std::numeric_limits<float>::max(), std::numeric_limits<float>::max()), std::memory_order_relaxed);
+}
+
+Task::Task(Task const & other) { * this = other; }
+
+Task & Task::operator=(Task const & other) {
+    this -> _identifier = other._identifier;
+    this -> _capture_set = other._capture_set;
+    this -> _feature_set = other._feature_set;
+    this -> _order = other._order;
+    this -> _vertex_index = other._vertex_index;
+    this -> _support = other._support;
+    this -> _base_objective = other._base_objective;
+    this -> _information = other._information;
+    this -> _bounds.store(other._bounds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this -> _guaranteed_lowerbound = other._guaranteed_lowerbound;
+    this -> _context_lowerbound = other._context_lowerbound;
+    this -> _context_upperbound = other._context_upperbound;
+    this -> _lowerscope.store(other._lowerscope.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this -> _upperscope.store(other._upperscope.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this -> _coverage = other._coverage;
+    this -> _optimal_feature.store(other._optimal_feature.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return * this;
+}
 
 Task::Task(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id) {
     this -> _capture_set = capture_set;
     this -> _feature_set = feature_set;
-    this -> _support = (float)(capture_set.count()) / (float)(State::dataset.height());
-    float const regularization = Configuration::regularization;
+    this -> _support = State::dataset().weight(capture_set) / State::dataset().total_weight();
     bool terminal = (this -> _capture_set.count() <= 1) || (this -> _feature_set.empty());
 
     float potential, min_loss, guaranteed_min_loss, max_loss;
     unsigned int target_index;
     // Careful, the following method modifies capture_set
-    State::dataset.summary(this -> _capture_set, this -> _information, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
+    State::dataset().summary(this -> _capture_set, this -> _information, potential, min_loss, guaranteed_min_loss, max_loss, target_index, id);
 
+    characterize(potential, min_loss, guaranteed_min_loss, max_loss, terminal, this -> _capture_set.get_depth_budget());
+}
+
+Task::Task(SplitSummary const & summary, unsigned char depth_budget) {
+    this -> _support = (float)(summary.support) / (float)(State::dataset().size());
+    this -> _information = summary.info;
+    characterize(summary.potential, summary.min_loss, summary.guaranteed_min_loss, summary.max_loss, summary.support <= 1, depth_budget);
+}
+
+void Task::characterize(float potential, float min_loss, float guaranteed_min_loss, float max_loss, bool terminal, unsigned char depth_budget) {
+    float const regularization = Configuration::regularization();
     this -> _base_objective = max_loss + regularization; //add 1*regularization because the max loss still uses one leaf
     // Since _base_objective corresponds to the best tree with just one leaf, any tree with a better objective must use at least 2 leaves.
     // So we add 2*regularization to the min_loss in the calculation below
@@ -26,111 +79,161 @@ Task::Task(Bitmask const & capture_set, Bitmask const & feature_set, unsigned in
     this -> _guaranteed_lowerbound = std::min(this -> _base_objective, guaranteed_min_loss + 2 * regularization);
 
     // use lowerbound and upperbound to decide whether further splits are possible
+    float initial_lowerbound, initial_upperbound;
     if ( (1.0 - min_loss < regularization ) // Insufficient maximum accuracy
         || ( potential < 2 * regularization && (1.0 - max_loss) < regularization) ) // Leaf Support + Incremental Accuracy
     { // Insufficient support and leaf accuracy
         // Node is provably not part of any optimal tree
-        this -> _lowerbound = this -> _base_objective;
-        this -> _upperbound = this -> _base_objective;
+        initial_lowerbound = this -> _base_objective;
+        initial_upperbound = this -> _base_objective;
         this -> _feature_set.clear();
     } else if (
-        max_loss - min_loss < regularization // Accuracy (also catches case where min_loss > max_loss, for Configuration::reference_LB)
+        max_loss - min_loss < regularization // Accuracy (also catches case where min_loss > max_loss, for Configuration::reference_LB())
         || potential < 2 * regularization // Leaf Support
         || terminal
-        || (Configuration::depth_budget != 0 && capture_set.get_depth_budget() == 1) // we are using depth constraints, and depth budget is exhausted
+        || (Configuration::depth_budget() != 0 && depth_budget == 1) // we are using depth constraints, and depth budget is exhausted
     ) {
         // Node is provably not an internal node of any optimal tree
-        this -> _lowerbound = this -> _base_objective;
-        this -> _upperbound = this -> _base_objective;
+        initial_lowerbound = this -> _base_objective;
+        initial_upperbound = this -> _base_objective;
         this -> _feature_set.clear();
         
     } else {
         // Node can be either an internal node or leaf
-        this -> _lowerbound = lowerbound;
-        this -> _upperbound = upperbound;
+        initial_lowerbound = lowerbound;
+        initial_upperbound = upperbound;
     }
+    // Construction is single-threaded; the task becomes shared only once it is stored
+    this -> _bounds.store(pack_bounds(initial_lowerbound, initial_upperbound), std::memory_order_relaxed);
 
-    if (this -> _lowerbound > this -> _upperbound) {
+    if (initial_lowerbound > initial_upperbound) {
         std::stringstream reason;
-        reason << "Invalid Lowerbound (" << this -> _lowerbound << ") or Upperbound (" << this -> _upperbound << ")." << std::endl;
+        reason << "Invalid Lowerbound (" << initial_lowerbound << ") or Upperbound (" << initial_upperbound << ")." << std::endl;
         throw IntegrityViolation("Task::Task", reason.str());
     }
 }
 
 float Task::support(void) const { return this -> _support; }
 
+// Ranks this task for the exploration queue; tbb::concurrent_priority_queue pops the
+// highest value first, so each policy returns larger numbers for tasks it favours
+float Task::exploration_priority(void) const {
+    // Under memory pressure, prefer the smallest (deepest) subproblems so the frontier
+    // collapses toward completed subtrees instead of fanning out breadth-first
+    if (State::pressure()) { return - this -> _support; }
+    std::string const & policy = Configuration::priority_policy();
+    if (policy == "lowerbound") { return - lowerbound(); } // Best lower bound first
+    if (policy == "gap") { return uncertainty(); } // Largest optimality gap first
+    if (policy == "depth") { return - this -> _support; } // Smallest subproblems first, minimizing the live frontier
+    if (policy == "hybrid" && (float)(std::rand()) / (float)(RAND_MAX) < Configuration::priority_epsilon()) {
+        return (float)(std::rand()) / (float)(RAND_MAX); // Occasional random rank to escape pathological orderings
+    }
+    return this -> _support - lowerbound(); // Default: largest promising support first
+}
+
 float Task::information(void) const { return this -> _information; }
 
 float Task::base_objective(void) const { return this -> _base_objective; }
 
-float Task::uncertainty(void) const { return std::max((float)(0.0), upperbound() - lowerbound()); }
+// The gap is decoded from one load of the packed word, so a concurrent tightening can
+// never produce a pair that was not stored together
+float Task::uncertainty(void) const {
+    float lower, upper;
+    unpack_bounds(this -> _bounds.load(std::memory_order_relaxed), lower, upper);
+    return std::max((float)(0.0), upper - lower);
+}
 
-float Task::lowerbound(void) const { return this -> _lowerbound; }
-float Task::upperbound(void) const { return this -> _upperbound; }
-float Task::lowerscope(void) const { return this -> _lowerscope; }
-float Task::upperscope(void) const { return this -> _upperscope; }
+float Task::lowerbound(void) const {
+    float lower, upper;
+    unpack_bounds(this -> _bounds.load(std::memory_order_relaxed), lower, upper);
+    return lower;
+}
+float Task::upperbound(void) const {
+    float lower, upper;
+    unpack_bounds(this -> _bounds.load(std::memory_order_relaxed), lower, upper);
+    return upper;
+}
+float Task::lowerscope(void) const { return this -> _lowerscope.load(std::memory_order_relaxed); }
+float Task::upperscope(void) const { return this -> _upperscope.load(std::memory_order_relaxed); }
 
 double Task::guaranteed_lowerbound(void) { 
-    return (Configuration::reference_LB)? this -> _guaranteed_lowerbound : this -> _lowerbound;
+    return (Configuration::reference_LB())? this -> _guaranteed_lowerbound : lowerbound();
 }
 
 Bitmask const & Task::capture_set(void) const { return this -> _capture_set; }
 Bitmask const & Task::feature_set(void) const { return this -> _feature_set; }
 Tile & Task::identifier(void) { return this -> _identifier; }
-std::vector<int> & Task::order(void) { return this -> _order; }
+Tile const & Task::identifier(void) const { return this -> _identifier; }
+shared_translation & Task::order(void) { return this -> _order; }
+shared_translation const & Task::order(void) const { return this -> _order; }
+unsigned int & Task::vertex_index(void) { return this -> _vertex_index; }
 
-void Task::scope(float new_scope) {
+void Task::scope(float new_scope) const {
     if (new_scope == 0) { return; }
     new_scope = std::max((float)(0.0), new_scope);
-    this -> _upperscope = this -> _upperscope == std::numeric_limits<float>::max() ? new_scope : std::max(this -> _upperscope, new_scope);
-    this -> _lowerscope = this -> _lowerscope == -std::numeric_limits<float>::max() ? new_scope : std::min(this -> _lowerscope, new_scope);
+    // Each side widens independently through its own CAS loop; the extreme sentinels mark
+    // an unset scope and are replaced outright rather than folded into the extremum
+    float observed = this -> _upperscope.load(std::memory_order_relaxed);
+    while (true) {
+        float const desired = observed == std::numeric_limits<float>::max() ? new_scope : std::max(observed, new_scope);
+        if (desired == observed) { break; }
+        if (this -> _upperscope.compare_exchange_weak(observed, desired, std::memory_order_relaxed)) { break; }
+    }
+    observed = this -> _lowerscope.load(std::memory_order_relaxed);
+    while (true) {
+        float const desired = observed == -std::numeric_limits<float>::max() ? new_scope : std::min(observed, new_scope);
+        if (desired == observed) { break; }
+        if (this -> _lowerscope.compare_exchange_weak(observed, desired, std::memory_order_relaxed)) { break; }
+    }
 }
 
 void Task::prune_feature(unsigned int index) { this -> _feature_set.set(index, false); }
 
-void Task::create_children(unsigned int id) {    
-    Bitmask & buffer = State::locals[id].columns[0];
+void Task::create_children(unsigned int id) {
     bool conditions[2] = {false, true};
     Bitmask const & features = this -> _feature_set;
+    std::vector< SplitSummary > & negatives = State::locals()[id].negatives;
+    std::vector< SplitSummary > & positives = State::locals()[id].positives;
+    // Summarize both sides of every candidate split in one pass over the capture set
+    State::dataset().summarize_all(this -> _capture_set, features, negatives, positives, id);
+    unsigned char child_depth_budget = this -> _capture_set.get_depth_budget();
+    if (Configuration::depth_budget() != 0) { child_depth_budget -= 1; } // subproblems have one less depth_budget than their parent
     for (int j_begin = 0, j_end = 0; features.scan_range(true, j_begin, j_end); j_begin = j_end) {
         for (int j = j_begin; j < j_end; ++j) {
             bool skip = false;
             for (unsigned int k = 0; k < 2; ++k) {
-                buffer = this -> _capture_set;
-                State::dataset.subset(j, conditions[k], buffer);
-                if (buffer.empty() || buffer == this -> _capture_set) { skip = true; continue; }
-                Task child(buffer, this -> _feature_set, id);
-                State::locals[id].neighbourhood[2 * j + k] = child;
+                SplitSummary const & summary = conditions[k] ? positives[j] : negatives[j];
+                // A split is degenerate when either side captures no raw samples; testing both
+                // sides directly keeps the check exact even under importance weights
+                if (summary.support == 0) { skip = true; continue; }
+                // Store a bound-only placeholder; the capture subset is materialized lazily in
+                // send_explorer, so dominated children never allocate one
+                State::locals()[id].neighbourhood[2 * j + k] = Task(summary, child_depth_budget);
             }
             if (skip) { prune_feature(j); }
-
-
-            // Task & left = State::locals[id].neighbourhood[2 * j];
-            // Task & right = State::locals[id].neighbourhood[2 * j + 1];
-
         }
     }
 }
 
 void Task::prune_features(unsigned int id) {
-    if (Configuration::continuous_feature_exchange) { continuous_feature_exchange(id); }
-    if (Configuration::feature_exchange) { feature_exchange(id); }
+    if (Configuration::continuous_feature_exchange()) { continuous_feature_exchange(id); }
+    if (Configuration::feature_exchange()) { feature_exchange(id); }
 }
 
 void Task::continuous_feature_exchange(unsigned int id) {
     Bitmask const & features = this -> _feature_set;
-    for (auto it = State::dataset.encoder.boundaries.begin(); it != State::dataset.encoder.boundaries.end(); ++it) {
+    for (auto it = State::dataset().encoder.boundaries.begin(); it != State::dataset().encoder.boundaries.end(); ++it) {
         int start = it -> first, finish = it -> second;
         for (int i = features.scan(start, true), j = features.scan(i + 1, true); j < finish; i = j, j = features.scan(j + 1, true)) {
-            float alpha = State::locals[id].neighbourhood[2 * i].lowerbound();
-            float beta = State::locals[id].neighbourhood[2 * j].upperbound();
+            float alpha = State::locals()[id].neighbourhood[2 * i].lowerbound();
+            float beta = State::locals()[id].neighbourhood[2 * j].upperbound();
             if (alpha >= beta) { prune_feature(i); }
             if (j >= finish - 1) { break; }
         }
 
         for (int i = features.rscan(finish - 1, true), j = features.rscan(i - 1, true); j >= start; i = j, j = features.rscan(j - 1, true)) {
-            float alpha = State::locals[id].neighbourhood[2 * i + 1].lowerbound();
-            float beta = State::locals[id].neighbourhood[2 * j + 1].upperbound();
+            float alpha = State::locals()[id].neighbourhood[2 * i + 1].lowerbound();
+            float beta = State::locals()[id].neighbourhood[2 * j + 1].upperbound();
             if (alpha >= beta) { prune_feature(i); }
             if (j <= start) { break; }
         }
@@ -140,7 +243,7 @@ void Task::continuous_feature_exchange(unsigned int id) {
 void Task::feature_exchange(unsigned int id) {
     Bitmask const & features = this -> _feature_set;
     int max = features.size();
-    Bitmask & buffer = State::locals[id].columns[0];
+    Bitmask & buffer = State::locals()[id].columns[0];
     for (int i = features.scan(0, true); i < max; i = features.scan(i + 1, true)) {
         for (int j = features.scan(0, true); j < max; j = features.scan(j + 1, true)) {
             if (i == j) { continue; }
@@ -148,14 +251,14 @@ void Task::feature_exchange(unsigned int id) {
                 buffer = this -> _capture_set;
                 bool i_sign = (bool)(k & 1);
                 bool j_sign = (bool)((k >> 1) & 1);
-                State::dataset.subset(i, i_sign, buffer); // population after applying i filter
+                State::dataset().subset(i, i_sign, buffer); // population after applying i filter
                 int i_count = buffer.count(); 
-                State::dataset.subset(j, j_sign, buffer); // population remaining if !j filter is applied
+                State::dataset().subset(j, j_sign, buffer); // population remaining if !j filter is applied
                 if (i_count != buffer.count()) { continue; } // implies that i is not a subset of j
                 // implies that i IS a subset of j, therefore !j is a subset of !i
                 // (since i + !i covers the same set as j + !j)
-                float not_i_risk = State::locals[id].neighbourhood[2 * i + (int)(!i_sign)].upperbound();
-                float not_j_risk = State::locals[id].neighbourhood[2 * j + (int)(!j_sign)].lowerbound();
+                float not_i_risk = State::locals()[id].neighbourhood[2 * i + (int)(!i_sign)].upperbound();
+                float not_j_risk = State::locals()[id].neighbourhood[2 * j + (int)(!j_sign)].lowerbound();
                 // not_i_risk <= not_j_risk and i IS a subset of j implies that risk_i <= risk_j
                 if (not_i_risk <= not_j_risk && features.get(i)) { prune_feature(j); break; }
             }
@@ -168,15 +271,15 @@ void Task::send_explorers(float new_scope, unsigned int id) {
     this -> scope(new_scope);
 
     float exploration_boundary = upperbound();
-    if (Configuration::look_ahead) { exploration_boundary = std::min(exploration_boundary, this -> _upperscope); }
+    if (Configuration::look_ahead()) { exploration_boundary = std::min(exploration_boundary, upperscope()); }
 
     Bitmask const & features = this -> _feature_set;
     for (int j_begin = 0, j_end = 0; features.scan_range(true, j_begin, j_end); j_begin = j_end) {
         for (unsigned int j = j_begin; j < j_end; ++j) {
-            Task & left = State::locals[id].neighbourhood[2 * j];
-            Task & right = State::locals[id].neighbourhood[2 * j + 1];
+            Task & left = State::locals()[id].neighbourhood[2 * j];
+            Task & right = State::locals()[id].neighbourhood[2 * j + 1];
             float lower, upper;
-            if (Configuration::rule_list) {
+            if (Configuration::rule_list()) {
                 lower = std::min(left.lowerbound() + right.base_objective(), left.base_objective() + right.lowerbound());
                 upper = std::min(left.upperbound() + right.base_objective(), left.base_objective() + right.upperbound());
             } else {
@@ -190,29 +293,34 @@ void Task::send_explorers(float new_scope, unsigned int id) {
             if (lower > exploration_boundary) { continue; } // Skip children that are out of scope
             if (upper <= this -> _coverage) { continue; } // Skip children that have been explored
 
-            if (Configuration::rule_list) {
-                send_explorer(left, exploration_boundary - right.base_objective(), -(j + 1), id);
-                send_explorer(right, exploration_boundary - left.base_objective(), (j + 1), id);
+            if (Configuration::rule_list()) {
+                send_explorer(exploration_boundary - right.base_objective(), -(j + 1), id);
+                send_explorer(exploration_boundary - left.base_objective(), (j + 1), id);
             } else {
-                send_explorer(left, exploration_boundary - right.guaranteed_lowerbound(), -(j + 1), id);
-                send_explorer(right, exploration_boundary - left.guaranteed_lowerbound(), (j + 1), id);
+                send_explorer(exploration_boundary - right.guaranteed_lowerbound(), -(j + 1), id);
+                send_explorer(exploration_boundary - left.guaranteed_lowerbound(), (j + 1), id);
             }
         }
     }
-    this -> _coverage = this -> _upperscope;
+    this -> _coverage = upperscope();
 }
 
-void Task::send_explorer(Task const & child, float scope, int feature, unsigned int id) {
+void Task::send_explorer(float scope, int feature, unsigned int id) {
     bool send = true;
     child_accessor key;
-    if (State::graph.children.find(key, std::make_pair(this -> identifier(), feature))) {
-        vertex_accessor child;
-        State::graph.vertices.find(child, key -> second);
-        if (scope < child -> second.upperscope()) {
+    if (State::graph().children.find(key, std::make_pair(this -> identifier(), feature))) {
+        // The scope widening is a CAS, so a shared accessor suffices and explorers probing
+        // a hot child do not serialize behind its own dispatch step
+        // Collection only unlinks a condemned vertex's own child entries, so this entry can
+        // name a vertex that has since been reclaimed; a failed look-up falls through to
+        // sending the explorer, which recreates the child, just as load_children tolerates it
+        const_vertex_accessor child;
+        if (State::graph().vertices.find(child, State::graph().identifier(key -> second))
+            && scope < child -> second.upperscope()) {
             adjacency_accessor parents;
-            State::graph.edges.find(parents, child -> second.identifier()); // insert backward look-up entry
+            State::graph().edges.find(parents, child -> second.identifier()); // insert backward look-up entry
             std::pair<adjacency_iterator, bool> insertion = parents -> second.insert(
-                std::make_pair(this -> identifier(), std::make_pair(Bitmask(State::dataset.width(), false), scope)));
+                std::make_pair(this -> identifier(), std::make_pair(Bitmask(State::dataset().width(), false), scope)));
             insertion.first -> second.first.set(std::abs(feature) - 1, true);
             insertion.first -> second.second = std::min(insertion.first -> second.second, scope);
             child -> second.scope(scope);
@@ -221,31 +329,78 @@ void Task::send_explorer(Task const & child, float scope, int feature, unsigned
         key.release();
     }
     if (send) {
-        State::locals[id].outbound_message.exploration(
-            this->_identifier,  // sender tile
-            child._capture_set, // recipient capture_set
-            this->_feature_set, // recipient feature_set
-            feature,            // feature
-            scope,              // scope
-            this->_support - this->_lowerbound); // priority
-        State::queue.push(State::locals[id].outbound_message);
+        // The neighbourhood holds bound-only placeholders, so the capture subset is
+        // materialized here, only for children that actually receive an explorer
+        // The subset lives on the stack when it fits under stack_limit so that it stays
+        // L1-resident; otherwise the shared column buffer is used as before
+        unsigned int scratch_blocks, scratch_offset;
+        Bitmask::block_layout(State::dataset().height(), & scratch_blocks, & scratch_offset);
+        size_t const scratch_bytes = scratch_blocks * sizeof(bitblock);
+        bool const on_stack = Configuration::stack_limit() > 0 && scratch_bytes <= Configuration::stack_limit();
+        bitblock * stack_blocks = (bitblock *) alloca(on_stack ? scratch_bytes : sizeof(bitblock));
+        Bitmask stack_capture(on_stack ? State::dataset().height() : 0, false, stack_blocks);
+        Bitmask & buffer = on_stack ? stack_capture : State::locals()[id].columns[0];
+        buffer = this -> _capture_set;
+        State::dataset().subset(std::abs(feature) - 1, feature > 0, buffer);
+        // The split feature is constant on both sides of the bisection, and on the positive
+        // side every other member of its exclusive equality block is constant false, so none
+        // of them can split a descendant; dropping them here narrows the feature scans of the
+        // whole subtree instead of rediscovering each as degenerate, one vertex at a time
+        Bitmask & descendant_features = State::locals()[id].rows[0];
+        descendant_features = this -> _feature_set;
+        descendant_features.set(std::abs(feature) - 1, false);
+        if (feature > 0) { State::dataset().exclude_siblings(std::abs(feature) - 1, descendant_features); }
+        float priority = exploration_priority();
+        State::locals()[id].outbound_message.exploration(
+            this->_identifier,   // sender tile
+            buffer,              // recipient capture_set
+            descendant_features, // recipient feature_set
+            feature,             // feature
+            scope,               // scope
+            priority);           // priority
+        State::queue().push(std::move(State::locals()[id].outbound_message));
     }
 }
 
 
-bool Task::update(float lower, float upper, int optimal_feature) {
-    bool change = lower != this -> _lowerbound || upper != this -> _upperbound;
-    this -> _lowerbound = std::max(this -> _lowerbound, lower);
-    this -> _upperbound = std::min(this -> _upperbound, upper);
-    this -> _lowerbound = std::min(this -> _upperbound, this -> _lowerbound);
-
-    this -> _optimal_feature = optimal_feature;
+void Task::reseed(float previous_regularization, float next_regularization) {
+    float const delta = previous_regularization - next_regularization;
+    unsigned int const leaf_limit = this -> _capture_set.count();
+    // Reseeding runs between solves while no worker is live, so plain load/store suffices
+    float current_lower, current_upper;
+    unpack_bounds(this -> _bounds.load(std::memory_order_relaxed), current_lower, current_upper);
+    this -> _base_objective += next_regularization - previous_regularization;
+    float const upper = std::min(current_upper, this -> _base_objective);
+    float const lower = std::min(upper, std::max((float)(0.0), current_lower - delta * leaf_limit));
+    this -> _bounds.store(pack_bounds(lower, upper), std::memory_order_relaxed);
+    this -> _guaranteed_lowerbound = std::max((float)(0.0), this -> _guaranteed_lowerbound - delta * leaf_limit);
+    this -> _lowerscope.store(-std::numeric_limits<float>::max(), std::memory_order_relaxed);
+    this -> _upperscope.store(std::numeric_limits<float>::max(), std::memory_order_relaxed);
+    this -> _coverage = -std::numeric_limits<float>::max();
+    this -> _optimal_feature.store(-1, std::memory_order_relaxed);
+}
 
-    float regularization = Configuration::regularization;
-    if ((Configuration::cancellation && 1.0 - this -> _lowerbound < 0.0)
-        || this -> _upperbound - this -> _lowerbound <= std::numeric_limits<float>::epsilon()) {
-        this -> _lowerbound = this -> _upperbound;
+bool Task::update(float lower, float upper, int optimal_feature) const {
+    // Merge through a CAS loop so concurrent updaters only ever tighten the stored pair;
+    // each retry re-derives the merged pair from the word that defeated the exchange
+    unsigned long long observed = this -> _bounds.load(std::memory_order_relaxed);
+    bool change;
+    while (true) {
+        float current_lower, current_upper;
+        unpack_bounds(observed, current_lower, current_upper);
+        change = lower != current_lower || upper != current_upper;
+        float next_lower = std::max(current_lower, lower);
+        float next_upper = std::min(current_upper, upper);
+        next_lower = std::min(next_upper, next_lower);
+        if ((Configuration::cancellation() && 1.0 - next_lower < 0.0)
+            || next_upper - next_lower <= std::numeric_limits<float>::epsilon()) {
+            next_lower = next_upper;
+        }
+        unsigned long long const desired = pack_bounds(next_lower, next_upper);
+        if (desired == observed) { break; }
+        if (this -> _bounds.compare_exchange_weak(observed, desired, std::memory_order_relaxed)) { break; }
     }
+    this -> _optimal_feature.store(optimal_feature, std::memory_order_relaxed);
     return change;
 }
 
@@ -253,8 +408,8 @@ std::string Task::inspect(void) const {
     std::stringstream status;
     status << "Capture: " << this -> _capture_set.to_string() << std::endl;
     // status << "  State[SEDRCIT] = " << (int)(sampled()) << (int)(explored()) << (int)(delegated()) << (int)(resolved()) << (int)(cancelled()) << (int)(informed()) << (int)(terminal()) << std::endl;
-    status << "  Base: " << this -> _base_objective << ", Bound: [" << this -> _lowerbound << ", " << this -> _upperbound << "]" << std::endl;
-    status << "  Coverage: " << this -> _coverage << ", Scope: [" << this -> _lowerscope << ", " << this  -> _upperscope << "]" << std::endl;
+    status << "  Base: " << this -> _base_objective << ", Bound: [" << lowerbound() << ", " << upperbound() << "]" << std::endl;
+    status << "  Coverage: " << this -> _coverage << ", Scope: [" << lowerscope() << ", " << upperscope() << "]" << std::endl;
     status << "  Feature: " << this -> _feature_set.to_string() << std::endl;
     return status.str();
 }
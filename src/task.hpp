@@ -1,6 +1,7 @@
 #ifndef TASK_H
 #define TASK_H
 
+#include <atomic>
 #include <vector>
 #include <tuple>
 #include <sstream>
@@ -25,13 +26,28 @@ class Task {
 public:
     Task(void);
 
+    // The objective bounds and scopes are atomics, which are not copyable by default; both
+    // operations take a consistent snapshot of the source's bounds and copy the rest plainly
+    Task(Task const & other);
+    Task & operator=(Task const & other);
+
     // @param capture_set: indicator for which data points are captured
     // @param feature_set: indicator for which features are still active
     Task(Bitmask const & capture_set, Bitmask const & feature_set, unsigned int id);
 
+    // @param summary: precomputed summary of the captured points, as produced by Dataset::summarize_all
+    // @param depth_budget: the remaining depth budget of the subproblem
+    // @note constructs a bound-only placeholder for the local neighbourhood; the capture and
+    //       feature sets are left unset and are materialized only if an explorer is actually sent
+    Task(SplitSummary const & summary, unsigned char depth_budget);
+
     // @returns the support of the this task
     float support(void) const;
 
+    // @returns the queue priority of messages emitted for this task under the configured
+    //          scheduling policy, overridden to depth-first under memory pressure
+    float exploration_priority(void) const;
+
     // @returns the objective lowerbound of this task
     float lowerbound(void) const;
 
@@ -45,7 +61,12 @@ public:
 
     float lowerscope(void) const;
     float upperscope(void) const;
-    void scope(float new_scope);
+
+    // @param new_scope: a scope budget under which this task was reached
+    // @modifies widens the scope window to admit new_scope
+    // @note lock-free; CAS loops keep the widening monotone under concurrent visitors, so
+    //       a shared accessor on the vertex suffices
+    void scope(float new_scope) const;
 
     // @return the objective optimality gap of this task
     float uncertainty(void) const;
@@ -63,8 +84,17 @@ public:
     Bitmask const & feature_set(void) const;
 
     Tile & identifier(void);
+    Tile const & identifier(void) const;
     Tile & parent(void);
-    std::vector<int> & order(void);
+
+    // @return the interned translation undoing this task's tile canonicalization; the null
+    //         handle denotes the identity
+    shared_translation & order(void);
+    shared_translation const & order(void) const;
+
+    // @return the dense index interned for this vertex when it was first stored, through
+    //         which secondary tables reference it without copying the identifier
+    unsigned int & vertex_index(void);
 
     // @modifies: prunes features
     void prune_feature(unsigned int id);
@@ -83,38 +113,72 @@ public:
 
     void send_explorers(float scope, unsigned int id);
 
-    void send_explorer(Task const & child, float scope, int feature, unsigned int id);
-
-    bool update(float lower, float upper, int optimal_feature);
+    void send_explorer(float scope, int feature, unsigned int id);
+
+    // @param lower, upper: externally derived objective bounds to merge into this task
+    // @param optimal_feature: the feature achieving the merged upper bound, or -1
+    // @returns whether the merged bounds differ from the previously stored pair
+    // @note lock-free; the bounds live in one packed atomic word updated by a CAS loop, so
+    //       the pair only ever tightens under concurrent updaters and readers holding only
+    //       a shared accessor decode a consistent snapshot from a single load
+    bool update(float lower, float upper, int optimal_feature) const;
+
+    // @param previous_regularization: the regularization under which the current bounds were computed
+    // @param next_regularization: the regularization of the upcoming solve
+    // @modifies relaxes the objective bounds so they remain valid under the new regularization
+    //           and resets scope state derived from the previous solve
+    // @note an upper bound stays valid when the regularization decreases, since the tree that
+    //       achieved it only gets cheaper; lower bounds are relaxed by the maximum possible
+    //       saving, which is bounded by the number of captured samples (one leaf each)
+    void reseed(float previous_regularization, float next_regularization);
 
     // observer method used for debugging
     std::string inspect(void) const;
 private:
+    // @param potential, min_loss, guaranteed_min_loss, max_loss: summary statistics of the captured points
+    // @param terminal: whether the task is too small or feature-starved to split further
+    // @modifies derives the objective bounds shared by both constructors
+    void characterize(float potential, float min_loss, float guaranteed_min_loss, float max_loss, bool terminal, unsigned char depth_budget);
+
+    // @param lower, upper: the bound pair to pack
+    // @returns the pair packed into one word, lower bound in the low half
+    static unsigned long long pack_bounds(float lower, float upper);
+
+    // @param packed: a word previously produced by pack_bounds
+    // @modifies lower, upper: overwritten with the decoded bound pair
+    static void unpack_bounds(unsigned long long packed, float & lower, float & upper);
+
     Tile _identifier;
     Bitmask _capture_set;
     Bitmask _feature_set;
 
-    std::vector<int> _order;
+    shared_translation _order;
+
+    unsigned int _vertex_index = std::numeric_limits<unsigned int>::max(); // Dense index assigned on first storage; the sentinel marks an unstored task
 
     float _support;
     float _base_objective;
     float _information;
 
-    float _lowerbound = -std::numeric_limits<float>::max();
-    float _upperbound = std::numeric_limits<float>::max();
+    // The objective bound pair, packed into one atomic word so hot vertices near the root
+    // are read and tightened without holding their bucket lock exclusively; mutable because
+    // tightening through a shared accessor is semantically a refinement, not a modification
+    mutable std::atomic< unsigned long long > _bounds;
 
-    // When Configuration::reference_LB is true, _lowerbound is no longer a provable lower bound
+    // When Configuration::reference_LB() is true, _lowerbound is no longer a provable lower bound
     // we use the below variable to track a provable lower bound in this case. 
     float _guaranteed_lowerbound = -std::numeric_limits<float>::max(); 
 
     float _context_lowerbound = 0.0;
     float _context_upperbound = 0.0;
 
-    float _lowerscope = -std::numeric_limits<float>::max();
-    float _upperscope = std::numeric_limits<float>::max();
+    // The scope window, widened concurrently by every parent that reaches this vertex;
+    // the extreme values mark a scope that has not been set yet
+    mutable std::atomic< float > _lowerscope { -std::numeric_limits<float>::max() };
+    mutable std::atomic< float > _upperscope { std::numeric_limits<float>::max() };
     float _coverage = -std::numeric_limits<float>::max();
 
-    int _optimal_feature = -1; // Feature index set if part of the oracle model
+    mutable std::atomic< int > _optimal_feature { -1 }; // Feature index set if part of the oracle model
 };
 
 #endif
\ No newline at end of file
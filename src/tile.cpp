@@ -10,11 +10,27 @@ Tile::Tile(void) {};
 Tile::~Tile(void) {};
 
 Tile & Tile::operator=(Tile const & other) {
-    this -> _content = other._content;
+    // Recycled message tiles are reused across subproblems whose canonical forms differ in
+    // size, so assignment rebuilds the storage when the recycled capacity cannot hold the content
+    if (other._content.size() > this -> _content.capacity()) {
+        Bitmask replacement(other._content);
+        this -> _content.swap(replacement);
+    } else {
+        this -> _content = other._content;
+    }
     this -> _width = other._width;
+    this -> _hash = other._hash;
+    this -> _hashed = other._hashed;
     return * this;
 };
 
+void Tile::swap(Tile & other) {
+    this -> _content.swap(other._content);
+    std::swap(this -> _width, other._width);
+    std::swap(this -> _hash, other._hash);
+    std::swap(this -> _hashed, other._hashed);
+}
+
 bool Tile::operator==(Tile const & other) const {
     return (this -> _width == other._width) && (this -> _content == other._content);
 }
@@ -24,20 +40,43 @@ bool Tile::operator!=(Tile const & other) const {
 }
 
 size_t Tile::hash(void) const {
-    size_t seed = this -> _width;
-    seed ^= this -> _content.hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    return seed;
+    if (!(this -> _hashed)) {
+        size_t seed = this -> _width;
+        seed ^= this -> _content.hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        this -> _hash = seed;
+        this -> _hashed = true;
+    }
+    return this -> _hash;
 }
 
 unsigned int Tile::size(void) const { return this -> _content.size(); }
 
-void Tile::resize(unsigned int new_size) { this -> _content.resize(new_size); }
+void Tile::resize(unsigned int new_size) {
+    this -> _content.resize(new_size);
+    this -> _hashed = false;
+}
 
-Bitmask & Tile::content(void) { return this -> _content; }
-void Tile::content(Bitmask const & _new_content) { this -> _content = _new_content; }
+Bitmask const & Tile::content(void) const { return this -> _content; }
+
+Bitmask & Tile::content(void) {
+    this -> _hashed = false; // The caller may mutate the content through this reference
+    return this -> _content;
+}
+void Tile::content(Bitmask const & _new_content) {
+    if (_new_content.size() > this -> _content.capacity()) {
+        Bitmask replacement(_new_content);
+        this -> _content.swap(replacement);
+    } else {
+        this -> _content = _new_content;
+    }
+    this -> _hashed = false;
+}
 
 unsigned int Tile::width(void) const { return this -> _width; }
-void Tile::width(unsigned int _new_width) { this -> _width = _new_width; }
+void Tile::width(unsigned int _new_width) {
+    this -> _width = _new_width;
+    this -> _hashed = false;
+}
 
 std::string Tile::to_string(void) const {
     if (this -> _content.size() == 0) { return "Empty"; }
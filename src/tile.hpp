@@ -2,10 +2,20 @@
 #define TILE_H
 
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "bitmask.hpp"
 
+// A translation maps canonical column positions back to the indices a subproblem stores
+// there, which model extraction composes to undo tile canonicalization
+typedef std::vector<int> translation_type;
+
+// Shared handle to an interned translation; translations are immutable once interned, and
+// the null handle denotes the identity so the common untranslated case carries no storage
+typedef std::shared_ptr< translation_type const > shared_translation;
+
 // Container for tiles which represent an equivalence class of data sets
 class Tile {
 public:
@@ -23,16 +33,24 @@ public:
     // Assignment operator used to transfer ownership of data
     Tile & operator=(Tile const & other);
 
+    // @param other: the tile to exchange contents with
+    // @modifies _content: storage is exchanged with other, no bits are copied
+    void swap(Tile & other);
+
     // Comparison operators used to match different tiles
     bool operator==(Tile const & other) const;
     bool operator!=(Tile const & other) const;
 
     // Accessors used to inspect/modify the content
     Bitmask & content(void);
+    Bitmask const & content(void) const;
     void content(Bitmask const & _new_content);
     unsigned int width(void) const;
     void width(unsigned int _new_width);
 
+    // @returns the hash value of this tile
+    // @note the value is computed on first use and memoized until the next mutation,
+    //       so repeated look-ups with the same tile avoid rescanning the content mask
     size_t hash(void) const;
 
     unsigned int size(void) const;
@@ -43,6 +61,8 @@ public:
 private:
     Bitmask _content;
     unsigned int _width;
+    mutable size_t _hash = 0; // Memoized hash value, valid only while _hashed is set
+    mutable bool _hashed = false; // Flag cleared by any mutation to force recomputation
 };
 
 // Overrides for STD containers
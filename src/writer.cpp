@@ -0,0 +1,44 @@
+#include "writer.hpp"
+
+tbb::concurrent_bounded_queue< std::pair< std::string, std::string > > Writer::ring;
+std::once_flag Writer::started;
+std::atomic< unsigned long long > Writer::submitted(0);
+unsigned long long Writer::completed = 0;
+std::mutex Writer::sync;
+std::condition_variable Writer::drained;
+
+void Writer::write(std::string const & path, std::string && content) {
+    start();
+    Writer::submitted.fetch_add(1, std::memory_order_relaxed);
+    Writer::ring.push(std::make_pair(path, std::move(content)));
+}
+
+void Writer::flush(void) {
+    unsigned long long const pending = Writer::submitted.load(std::memory_order_relaxed);
+    std::unique_lock< std::mutex > lock(Writer::sync);
+    Writer::drained.wait(lock, [pending]() { return Writer::completed >= pending; });
+}
+
+void Writer::start(void) {
+    std::call_once(Writer::started, []() {
+        Writer::ring.set_capacity(Writer::ring_capacity);
+        // The thread is detached rather than joined at exit since it spends its life blocked
+        // on the ring; flush provides the durability boundary for outputs that must survive
+        std::thread(Writer::loop).detach();
+    });
+}
+
+void Writer::loop(void) {
+    std::pair< std::string, std::string > snapshot;
+    while (true) {
+        Writer::ring.pop(snapshot); // Blocks until a snapshot is submitted
+        std::ofstream out(snapshot.first);
+        out << snapshot.second;
+        out.close();
+        {
+            std::lock_guard< std::mutex > lock(Writer::sync);
+            Writer::completed += 1;
+        }
+        Writer::drained.notify_all();
+    }
+}
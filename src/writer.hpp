@@ -0,0 +1,47 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <tbb/concurrent_queue.h>
+
+// Asynchronous buffered writer for trace, tree, and model outputs
+// Serialized snapshots are handed to a dedicated writer thread through a bounded ring,
+// so file I/O for diagnostics and results never runs on an optimization worker
+class Writer {
+public:
+    // @param path: destination file, overwritten if it already exists
+    // @param content: serialized bytes to store; consumed by this call
+    // @note returns as soon as the snapshot is enqueued; blocks only when ring_capacity
+    //       writes are already pending, which indicates the file system is the bottleneck
+    static void write(std::string const & path, std::string && content);
+
+    // @modifies blocks until every previously submitted write has been stored
+    // @note call before reading back any file produced through write
+    static void flush(void);
+
+private:
+    // Maximum number of pending snapshots held in memory before submission blocks
+    static const unsigned int ring_capacity = 256;
+
+    // @modifies starts the writer thread on first use; subsequent calls are no-ops
+    static void start(void);
+
+    // @note body of the writer thread; stores snapshots in submission order, forever
+    static void loop(void);
+
+    static tbb::concurrent_bounded_queue< std::pair< std::string, std::string > > ring;
+    static std::once_flag started;
+    static std::atomic< unsigned long long > submitted; // Writes enqueued so far
+    static unsigned long long completed; // Writes stored so far, guarded by sync
+    static std::mutex sync;
+    static std::condition_variable drained;
+};
+
+#endif
@@ -0,0 +1,17 @@
+#include "benchmark.hpp"
+#include "benchmark_bitmask.hpp"
+#include "benchmark_index.hpp"
+#include "benchmark_queue.hpp"
+#include "benchmark_dataset.hpp"
+
+// Microbenchmarks for the kernels on the training hot path. Each suite prints one line
+// per parameterization; run this per commit and diff the numbers to catch regressions
+// without training a full model
+int main() {
+    std::cout << "GOSDT Microbenchmarks" << std::endl;
+    benchmark_bitmask();
+    benchmark_index();
+    benchmark_queue();
+    benchmark_dataset();
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Sink for kernel results; accumulating into a volatile prevents the compiler from
+// discarding a measured kernel as dead code
+volatile unsigned long long benchmark_sink = 0;
+
+// @param name: the kernel being measured
+// @param parameters: the parameterization of this run (mask sizes, densities, thread counts)
+// @param iterations: the number of kernel invocations measured
+// @param seconds: total wall time spent in the measured invocations
+// @modifies prints one line with the per-operation latency and the throughput
+void benchmark_report(std::string name, std::string parameters, unsigned long long iterations, double seconds) {
+    double const nanoseconds = 1.0e9 * seconds / iterations;
+    double const throughput = iterations / seconds / 1.0e6;
+    std::cout << "  " << std::left << std::setw(24) << name << std::setw(36) << parameters << std::right
+        << std::setw(10) << iterations << " ops"
+        << std::fixed << std::setprecision(1) << std::setw(14) << nanoseconds << " ns/op"
+        << std::setprecision(3) << std::setw(12) << throughput << " Mops/s" << std::endl;
+}
+
+// @param state: generator state, advanced by one step
+// @returns a pseudo-random value from a fixed-seed linear congruential generator, so the
+//          same inputs are measured on every run and numbers are comparable across commits
+unsigned long long benchmark_random(unsigned long long & state) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+}
+
+// @returns the current wall time, used to bracket a batch of kernel invocations
+std::chrono::high_resolution_clock::time_point benchmark_now(void) {
+    return std::chrono::high_resolution_clock::now();
+}
+
+// @param start: wall time when the measured batch began
+// @returns the number of seconds elapsed since start
+double benchmark_elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration_cast< std::chrono::duration< double > >(benchmark_now() - start).count();
+}
+
+#endif
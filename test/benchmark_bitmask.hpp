@@ -0,0 +1,45 @@
+#include "../src/bitmask.hpp"
+
+// Measures the Bitmask kernels that dominate capture set manipulation: bit_and is the
+// subset operation applied once per candidate split, and count/words/hash run over every
+// capture set that enters the dependency graph
+void benchmark_bitmask(void) {
+    std::cout << "Bitmask Kernels" << std::endl;
+    unsigned int const sizes[] = { 256, 4096, 65536, 1048576 };
+    for (unsigned int index = 0; index < sizeof(sizes) / sizeof(sizes[0]); ++index) {
+        unsigned int const size = sizes[index];
+        // Scale repetitions inversely with mask size so each parameterization touches a
+        // comparable number of bits
+        unsigned long long const repetitions = std::max(1024ULL, (unsigned long long)(1 << 28) / size);
+        unsigned long long seed = 88172645463325252ULL;
+        Bitmask left(size);
+        Bitmask right(size);
+        for (unsigned int i = 0; i < size; ++i) {
+            left.set(i, (benchmark_random(seed) & 1) == 1);
+            right.set(i, (benchmark_random(seed) & 1) == 1);
+        }
+        std::stringstream parameters;
+        parameters << "[size=" << size << "]";
+
+        {
+            auto start = benchmark_now();
+            for (unsigned long long i = 0; i < repetitions; ++i) { left.bit_and(right); }
+            benchmark_report("Bitmask::bit_and", parameters.str(), repetitions, benchmark_elapsed(start));
+        }
+        {
+            auto start = benchmark_now();
+            for (unsigned long long i = 0; i < repetitions; ++i) { benchmark_sink += right.count(); }
+            benchmark_report("Bitmask::count", parameters.str(), repetitions, benchmark_elapsed(start));
+        }
+        {
+            auto start = benchmark_now();
+            for (unsigned long long i = 0; i < repetitions; ++i) { benchmark_sink += right.words(); }
+            benchmark_report("Bitmask::words", parameters.str(), repetitions, benchmark_elapsed(start));
+        }
+        {
+            auto start = benchmark_now();
+            for (unsigned long long i = 0; i < repetitions; ++i) { benchmark_sink += right.hash(); }
+            benchmark_report("Bitmask::hash", parameters.str(), repetitions, benchmark_elapsed(start));
+        }
+    }
+}
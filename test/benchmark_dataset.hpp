@@ -0,0 +1,51 @@
+#include "../src/state.hpp"
+
+// Measures Dataset::summary, the leaf evaluation performed for every vertex and every
+// candidate child, on a synthetic dataset whose shape resembles a binarized workload
+void benchmark_dataset(void) {
+    std::cout << "Dataset Kernels" << std::endl;
+    unsigned int const samples = 4096;
+    unsigned int const features = 32;
+    unsigned int const densities[] = { 25, 50, 100 };
+
+    // Synthesize a binary dataset with a noisily feature-dependent label so the summary
+    // runs over a realistic class mixture
+    unsigned long long seed = 88172645463325252ULL;
+    std::stringstream data;
+    for (unsigned int j = 0; j < features; ++j) { data << "x" << j << ","; }
+    data << "y" << std::endl;
+    for (unsigned int i = 0; i < samples; ++i) {
+        unsigned int ones = 0;
+        for (unsigned int j = 0; j < features; ++j) {
+            unsigned int const bit = benchmark_random(seed) & 1;
+            ones += bit;
+            data << bit << ",";
+        }
+        data << (((ones + (benchmark_random(seed) % 8)) > features / 2) ? 1 : 0) << std::endl;
+    }
+
+    Configuration::worker_limit() = 1;
+    State::initialize(data, 1);
+
+    for (unsigned int index = 0; index < sizeof(densities) / sizeof(densities[0]); ++index) {
+        unsigned int const density = densities[index];
+        Bitmask capture(State::dataset().height(), true);
+        for (unsigned int i = 0; i < State::dataset().height(); ++i) {
+            capture.set(i, (benchmark_random(seed) % 100) < density);
+        }
+        std::stringstream parameters;
+        parameters << "[samples=" << samples << ", density=" << density << "%]";
+
+        unsigned long long const repetitions = 4096;
+        float info, potential, min_loss, guaranteed_min_loss, max_loss;
+        unsigned int target_index;
+        auto start = benchmark_now();
+        for (unsigned long long i = 0; i < repetitions; ++i) {
+            State::dataset().summary(capture, info, potential, min_loss, guaranteed_min_loss, max_loss, target_index, 0);
+            benchmark_sink += target_index;
+        }
+        benchmark_report("Dataset::summary", parameters.str(), repetitions, benchmark_elapsed(start));
+    }
+
+    State::reset();
+}
@@ -0,0 +1,57 @@
+#include "../src/index.hpp"
+
+// Measures Index::sum, the prefix-sum gather behind every loss evaluation, across
+// indicator densities: sparse indicators produce many short runs, dense indicators few
+// long ones, and the two stress different parts of the run extraction
+void benchmark_index(void) {
+    std::cout << "Index Kernels" << std::endl;
+    unsigned int const sizes[] = { 1024, 16384 };
+    unsigned int const densities[] = { 10, 50, 90 };
+    unsigned int const width = 3;
+    for (unsigned int size_index = 0; size_index < sizeof(sizes) / sizeof(sizes[0]); ++size_index) {
+        unsigned int const size = sizes[size_index];
+        unsigned long long seed = 88172645463325252ULL;
+        std::vector< std::vector< float > > source;
+        for (unsigned int i = 0; i < size; ++i) {
+            std::vector< float > row;
+            for (unsigned int j = 0; j < width; ++j) {
+                row.emplace_back((benchmark_random(seed) % 1000) / 1000.0);
+            }
+            source.emplace_back(row);
+        }
+        Index index(source);
+        for (unsigned int density_index = 0; density_index < sizeof(densities) / sizeof(densities[0]); ++density_index) {
+            unsigned int const density = densities[density_index];
+            Bitmask indicator(size);
+            for (unsigned int i = 0; i < size; ++i) {
+                indicator.set(i, (benchmark_random(seed) % 100) < density);
+            }
+            std::stringstream parameters;
+            parameters << "[size=" << size << ", density=" << density << "%]";
+
+            unsigned long long const repetitions = std::max(256ULL, (unsigned long long)(1 << 22) / size);
+            std::vector< float > accumulator(width, 0.0);
+            auto start = benchmark_now();
+            for (unsigned long long i = 0; i < repetitions; ++i) {
+                index.sum(indicator, accumulator.data());
+                benchmark_sink += (unsigned long long)(accumulator[0]);
+            }
+            benchmark_report("Index::sum", parameters.str(), repetitions, benchmark_elapsed(start));
+        }
+    }
+
+    // The built-in comparison of the sum implementations, previously never wired to a target
+    {
+        unsigned long long seed = 88172645463325252ULL;
+        std::vector< std::vector< float > > source;
+        for (unsigned int i = 0; i < 4096; ++i) {
+            std::vector< float > row;
+            for (unsigned int j = 0; j < width; ++j) {
+                row.emplace_back((benchmark_random(seed) % 1000) / 1000.0);
+            }
+            source.emplace_back(row);
+        }
+        Index index(source);
+        index.benchmark();
+    }
+}
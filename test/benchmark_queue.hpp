@@ -0,0 +1,67 @@
+#include <thread>
+
+#include "../src/queue.hpp"
+#include "../src/tile.hpp"
+
+// Measures the sharded priority queue under contention: every worker iteration performs
+// one pop and dispatch performs up to one push per candidate split, so queue throughput
+// bounds how far the search scales with the worker count
+void benchmark_queue(void) {
+    std::cout << "Queue Kernels" << std::endl;
+    unsigned int const samples = 256;
+    unsigned int const features = 16;
+    unsigned int const targets = 2;
+    unsigned int const thread_counts[] = { 1, 2, 4, 8 };
+    unsigned long long const messages_per_thread = 16384;
+    for (unsigned int index = 0; index < sizeof(thread_counts) / sizeof(thread_counts[0]); ++index) {
+        unsigned int const threads = thread_counts[index];
+        Configuration::worker_limit() = threads; // Sizes the shards, as State::initialize would
+        Queue queue;
+        std::stringstream parameters;
+        parameters << "[threads=" << threads << "]";
+
+        // Phase 1: all threads push distinct exploration messages concurrently; the
+        // message rank is encoded into the capture set so the membership filter never
+        // rejects a push
+        {
+            std::vector< std::thread > team;
+            auto start = benchmark_now();
+            for (unsigned int id = 0; id < threads; ++id) {
+                team.emplace_back([=, & queue](void) {
+                    Message message;
+                    message.initialize(samples, features, targets);
+                    Bitmask capture(samples, true);
+                    Bitmask feature_set(features, true);
+                    for (unsigned long long i = 0; i < messages_per_thread; ++i) {
+                        unsigned long long const rank = id * messages_per_thread + i;
+                        for (unsigned int bit = 0; bit < 8 * sizeof(unsigned long long); ++bit) {
+                            capture.set(bit, ((rank >> bit) & 1) == 1);
+                        }
+                        message.exploration(Tile(), capture, feature_set, 0, std::numeric_limits< float >::max(), (float)(rank % 97));
+                        queue.push(std::move(message));
+                    }
+                });
+            }
+            for (unsigned int id = 0; id < threads; ++id) { team[id].join(); }
+            benchmark_report("Queue::push", parameters.str(), threads * messages_per_thread, benchmark_elapsed(start));
+        }
+
+        // Phase 2: all threads drain the queue concurrently, exercising the home shard
+        // and the stealing path once their home shard runs dry
+        {
+            std::vector< std::thread > team;
+            auto start = benchmark_now();
+            for (unsigned int id = 0; id < threads; ++id) {
+                team.emplace_back([=, & queue](void) {
+                    Message message;
+                    message.initialize(samples, features, targets);
+                    unsigned long long received = 0;
+                    while (queue.pop(message)) { received += 1; }
+                    benchmark_sink += received;
+                });
+            }
+            for (unsigned int id = 0; id < threads; ++id) { team[id].join(); }
+            benchmark_report("Queue::pop", parameters.str(), threads * messages_per_thread, benchmark_elapsed(start));
+        }
+    }
+}
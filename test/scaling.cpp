@@ -0,0 +1,125 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "../include/json/json.hpp"
+#include "../src/gosdt.hpp"
+
+using json = nlohmann::json;
+
+// @returns the peak resident set size of this process in kilobytes, or -1 where rusage
+//          is unavailable
+// @note the peak is process-wide and monotone, so the first run that grows the heap is
+//       charged for it; order the matrix from small to large when per-run peaks matter
+long peak_resident_size(void) {
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, & usage)) { return -1; }
+    return usage.ru_maxrss;
+#else
+    return -1;
+#endif
+}
+
+// Scaling benchmark harness. Runs GOSDT::fit over the cross product of a configuration
+// matrix and appends one JSON record per run to a report file, replacing the shell
+// scripts previously used to collect scaling numbers over the experiments datasets.
+//
+// The matrix file lists the dimensions to sweep; every other solver setting keeps its
+// default:
+//   {
+//     "datasets": ["experiments/datasets/monk1.csv"],
+//     "regularizations": [0.05],
+//     "depth_budgets": [0],
+//     "worker_limits": [1, 2, 4, 8],
+//     "time_limit": 300,
+//     "report": "scaling_report.jsonl"
+//   }
+int main(int argc, char * argv[]) {
+    if (argc != 2) {
+        std::cout << "Usage: gosdt_scaling [path to benchmark matrix]" << std::endl;
+        return 0;
+    }
+    if (!std::ifstream(argv[1]).good()) {
+        std::cout << "File Not Found: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ifstream matrix_stream(argv[1]);
+    json matrix = json::parse(matrix_stream);
+    std::vector< std::string > datasets = matrix.value("datasets", std::vector< std::string >());
+    std::vector< float > regularizations = matrix.value("regularizations", std::vector< float >{ 0.05 });
+    std::vector< unsigned char > depth_budgets = matrix.value("depth_budgets", std::vector< unsigned char >{ 0 });
+    std::vector< unsigned int > worker_limits = matrix.value("worker_limits", std::vector< unsigned int >{ 1 });
+    unsigned int time_limit = matrix.value("time_limit", 0);
+    std::string report_path = matrix.value("report", "scaling_report.jsonl");
+
+    if (datasets.size() == 0) {
+        std::cout << "The benchmark matrix lists no datasets" << std::endl;
+        return 1;
+    }
+    for (auto iterator = datasets.begin(); iterator != datasets.end(); ++iterator) {
+        if (!std::ifstream(* iterator).good()) {
+            std::cout << "File Not Found: " << * iterator << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream report(report_path, std::ios_base::app);
+    unsigned int const runs = datasets.size() * regularizations.size() * depth_budgets.size() * worker_limits.size();
+    unsigned int run = 0;
+    for (auto dataset = datasets.begin(); dataset != datasets.end(); ++dataset) {
+        for (auto regularization = regularizations.begin(); regularization != regularizations.end(); ++regularization) {
+            for (auto depth_budget = depth_budgets.begin(); depth_budget != depth_budgets.end(); ++depth_budget) {
+                for (auto worker_limit = worker_limits.begin(); worker_limit != worker_limits.end(); ++worker_limit) {
+                    run += 1;
+                    std::cout << "[" << run << "/" << runs << "] " << * dataset
+                        << " regularization=" << * regularization
+                        << " depth_budget=" << (unsigned int)(* depth_budget)
+                        << " worker_limit=" << * worker_limit << std::endl;
+
+                    // Each run configures from scratch so no setting leaks between cells
+                    json settings = json::object();
+                    settings["regularization"] = * regularization;
+                    settings["depth_budget"] = * depth_budget;
+                    settings["worker_limit"] = * worker_limit;
+                    settings["time_limit"] = time_limit;
+                    settings["verbose"] = false;
+                    std::istringstream settings_stream(settings.dump());
+                    Configuration::active() = Configuration::Values();
+                    Configuration::configure(settings_stream);
+
+                    std::ifstream data(* dataset);
+                    std::string result;
+                    GOSDT model;
+                    model.fit(data, result);
+
+                    json record = json::object();
+                    record["dataset"] = * dataset;
+                    record["regularization"] = * regularization;
+                    record["depth_budget"] = * depth_budget;
+                    record["worker_limit"] = * worker_limit;
+                    record["time"] = GOSDT::time;
+                    record["iterations"] = GOSDT::iterations;
+                    record["graph_size"] = GOSDT::size;
+                    record["status"] = GOSDT::status;
+                    record["lowerbound"] = GOSDT::lower_bound;
+                    record["upperbound"] = GOSDT::upper_bound;
+                    record["model_loss"] = GOSDT::model_loss;
+                    record["peak_rss"] = peak_resident_size();
+                    report << record.dump() << std::endl;
+                    report.flush();
+                }
+            }
+        }
+    }
+    std::cout << "Report written to " << report_path << std::endl;
+    return 0;
+}
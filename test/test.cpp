@@ -1,15 +1,19 @@
 #include "test.hpp"
 #include "test_bitmask.hpp"
+#include "test_dataset.hpp"
 #include "test_index.hpp"
 #include "test_queue.hpp"
+#include "test_state.hpp"
 #include "test_consistency.hpp"
 
 int main() {
     int failures = 0;
     std::map< std::string, int (*)(void) > units;
     units["Bitmask"] = test_bitmask;
+    units["Dataset"] = test_dataset;
     units["Index"] = test_index;
     units["Queue"] = test_queue;
+    units["State"] = test_state;
     units["Consistency"] = test_consistency;
 
     for (std::map< std::string, int (*)(void) >::iterator iterator = units.begin(); iterator != units.end(); ++iterator ) {
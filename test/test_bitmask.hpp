@@ -754,5 +754,62 @@ int test_bitmask(void) {
         failures += expect(false, d < c, "Bitmask::operator<(d, c)", context);
         failures += expect(false, d < d, "Bitmask::operator<(d, d)", context);
     }
+
+    {
+        std::string context = "Test Bitmask bitwise operations on wide masks (exercises the vectorized backend)";
+        unsigned int size = 8 * bitblock_size + 17; // Wide enough for the vector path plus an under-full tail block
+        Bitmask alpha(size);
+        Bitmask beta(size);
+        for (unsigned int i = 0; i < size; ++i) {
+            alpha.set(i, i % 3 == 0);
+            beta.set(i, i % 5 == 0);
+        }
+
+        { // Logical AND
+            Bitmask result(beta);
+            alpha.bit_and(result, false);
+            for (unsigned int i = 0; i < size; ++i) {
+                failures += expect((unsigned int)(i % 3 == 0 && i % 5 == 0), result.get(i), "Bitmask::bit_and produced an incorrect bit.", context);
+            }
+        }
+        { // Logical AND with flip
+            Bitmask result(beta);
+            alpha.bit_and(result, true);
+            for (unsigned int i = 0; i < size; ++i) {
+                failures += expect((unsigned int)(i % 3 != 0 && i % 5 == 0), result.get(i), "Bitmask::bit_and (flipped) produced an incorrect bit.", context);
+            }
+        }
+        { // Logical OR
+            Bitmask result(beta);
+            alpha.bit_or(result, false);
+            for (unsigned int i = 0; i < size; ++i) {
+                failures += expect((unsigned int)(i % 3 == 0 || i % 5 == 0), result.get(i), "Bitmask::bit_or produced an incorrect bit.", context);
+            }
+        }
+        { // Logical XOR
+            Bitmask result(beta);
+            alpha.bit_xor(result, false);
+            for (unsigned int i = 0; i < size; ++i) {
+                failures += expect((unsigned int)((i % 3 == 0) != (i % 5 == 0)), result.get(i), "Bitmask::bit_xor produced an incorrect bit.", context);
+            }
+        }
+        { // Fused conjunction count, which must agree with bit_and followed by count
+            Bitmask result(beta);
+            alpha.bit_and(result, false);
+            failures += expect(result.count(), alpha.and_count(beta), "Bitmask::and_count disagrees with bit_and followed by count.", context);
+            result = beta;
+            alpha.bit_and(result, true);
+            failures += expect(result.count(), alpha.and_count(beta, true), "Bitmask::and_count (flipped) disagrees with bit_and followed by count.", context);
+        }
+        { // Equality, including the flipped comparison
+            Bitmask gamma(alpha);
+            failures += expect(true, Bitmask::equals(alpha.data(), gamma.data(), size, false), "Bitmask::equals failed to match identical masks.", context);
+            failures += expect(false, Bitmask::equals(alpha.data(), beta.data(), size, false), "Bitmask::equals matched different masks.", context);
+            Bitmask delta(size);
+            for (unsigned int i = 0; i < size; ++i) { delta.set(i, !(i % 3 == 0)); }
+            failures += expect(true, Bitmask::equals(alpha.data(), delta.data(), size, true), "Bitmask::equals (flipped) failed to match complementary masks.", context);
+            failures += expect(false, Bitmask::equals(alpha.data(), gamma.data(), size, true), "Bitmask::equals (flipped) matched identical masks.", context);
+        }
+    }
     return failures;
 }
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "../src/gosdt.hpp"
+
+int test_dataset(void) {
+    int failures = 0;
+
+    {
+        std::string context = "Test Binary Matrix Ingestion";
+
+        // Re-express the csv fixture as a row-major byte matrix and check that training on
+        // the matrix finds the same objective as training on the csv
+        std::ifstream data("test/fixtures/dataset.csv");
+        std::string line;
+        std::getline(data, line); // Skip the header; the matrix path has no header
+        std::vector< unsigned char > matrix;
+        std::map< std::string, unsigned char > labels;
+        unsigned int samples = 0;
+        unsigned int columns = 0;
+        while (std::getline(data, line)) {
+            if (line.empty()) { continue; }
+            std::stringstream row(line);
+            std::string token;
+            std::vector< std::string > tokens;
+            while (std::getline(row, token, ',')) { tokens.push_back(token); }
+            for (unsigned int j = 0; j + 1 < tokens.size(); ++j) { matrix.push_back(tokens[j] == "1"); }
+            if (labels.find(tokens.back()) == labels.end()) { labels[tokens.back()] = labels.size(); }
+            matrix.push_back(labels[tokens.back()]);
+            columns = tokens.size();
+            samples += 1;
+        }
+
+        std::istringstream config_stream("{\"regularization\": 0.2}");
+        GOSDT::configure(config_stream);
+
+        std::unordered_set< Model > csv_models;
+        {
+            std::ifstream csv_data("test/fixtures/dataset.csv");
+            GOSDT model;
+            model.fit(csv_data, csv_models);
+        }
+
+        std::unordered_set< Model > matrix_models;
+        {
+            GOSDT model;
+            model.fit(matrix.data(), samples, columns, matrix_models);
+        }
+
+        failures += expect((int)(csv_models.size()), (int)(matrix_models.size()), "Incorrect number of models from matrix ingestion.", context);
+        failures += expect(csv_models.begin() -> loss(), matrix_models.begin() -> loss(), "Incorrect loss from matrix ingestion.", context);
+        failures += expect(csv_models.begin() -> complexity(), matrix_models.begin() -> complexity(), "Incorrect complexity from matrix ingestion.", context);
+    }
+
+    return failures;
+}
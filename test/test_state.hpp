@@ -0,0 +1,35 @@
+#include <thread>
+
+#include "../src/gosdt.hpp"
+
+int test_state(void) {
+    int failures = 0;
+
+    {
+        std::string context = "Test Concurrent Instance Isolation";
+
+        // Each fit runs on its own thread with its own configuration; the results must match
+        // the same fits run sequentially
+        auto solve = [](std::string path, std::string configuration, std::string & result) {
+            std::istringstream config_stream(configuration);
+            GOSDT::configure(config_stream);
+            std::ifstream data(path);
+            GOSDT model;
+            model.fit(data, result);
+        };
+
+        std::string sequential_a, sequential_b, concurrent_a, concurrent_b;
+        solve("test/fixtures/binary_sepal.csv", "{\"regularization\": 0.1}", sequential_a);
+        solve("test/fixtures/dataset.csv", "{\"regularization\": 0.2}", sequential_b);
+
+        std::thread first(solve, "test/fixtures/binary_sepal.csv", "{\"regularization\": 0.1}", std::ref(concurrent_a));
+        std::thread second(solve, "test/fixtures/dataset.csv", "{\"regularization\": 0.2}", std::ref(concurrent_b));
+        first.join();
+        second.join();
+
+        failures += expect(sequential_a, concurrent_a, "Concurrent fit changed the result of the first instance", context);
+        failures += expect(sequential_b, concurrent_b, "Concurrent fit changed the result of the second instance", context);
+    }
+
+    return failures;
+}